@@ -0,0 +1,45 @@
+#ifndef POTOK_BIT_HPP_
+#define POTOK_BIT_HPP_
+
+#include <potok/stdint.hpp>
+
+namespace potok {
+
+// c++17 stand-ins for the <bit> utilities we need
+//
+// `countr_zero` and `countl_zero` are only defined for non-zero inputs which lets the compiler lower them to a single
+// bsf/bsr (or tzcnt/lzcnt) without the zero check
+//
+
+constexpr auto countr_zero(u64 const x) -> u32
+{
+#if defined(__GNUC__) || defined(__clang__)
+  return static_cast<u32>(__builtin_ctzll(x));
+#else
+  auto n = u32{0};
+  while (!(x & (u64{1} << n))) { ++n; }
+  return n;
+#endif
+}
+
+constexpr auto countl_zero(u64 const x) -> u32
+{
+#if defined(__GNUC__) || defined(__clang__)
+  return static_cast<u32>(__builtin_clzll(x));
+#else
+  auto n = u32{0};
+  while (!(x & (u64{1} << (63 - n)))) { ++n; }
+  return n;
+#endif
+}
+
+// the smallest power of 2 that's not less than `x`, which must be at most 2^63
+//
+constexpr auto bit_ceil(u64 const x) -> u64
+{
+  return (x <= 1) ? 1 : u64{1} << (64 - countl_zero(x - 1));
+}
+
+}    // namespace potok
+
+#endif    // POTOK_BIT_HPP_
@@ -0,0 +1,105 @@
+#ifndef POTOK_BUFFER_CURSOR_HPP_
+#define POTOK_BUFFER_CURSOR_HPP_
+
+#include <potok/span.hpp>
+#include <potok/stdint.hpp>
+
+#include <boost/asio/buffer.hpp>
+
+#include <boost/assert.hpp>
+
+#include <type_traits>
+#include <utility>
+
+namespace potok {
+
+// a forward-only position within a ConstBufferSequence or MutableBufferSequence
+//
+// unlike `boost::asio::buffers_iterator`, which checks for the end of the current segment on every increment, the
+// cursor hands out the rest of the current segment as a `potok::span` so codecs can run plain pointer loops over it
+// and only cross into the next segment when they explicitly `advance` past the end of this one
+//
+// empty segments are skipped so `chunk()` is only ever empty once the whole sequence has been consumed
+//
+// the cursor refers to the buffer sequence rather than copying it so the sequence must outlive the cursor
+//
+template <class BufferSequence>
+class buffer_cursor {
+ public:
+  using value_type =
+      std::conditional_t<boost::asio::is_mutable_buffer_sequence<BufferSequence>::value, u8, u8 const>;
+
+ private:
+  using iterator = decltype(boost::asio::buffer_sequence_begin(std::declval<BufferSequence const&>()));
+
+  iterator         pos_;
+  iterator         end_;
+  span<value_type> chunk_;
+  usize            consumed_ = 0;
+
+  auto next_chunk() -> void
+  {
+    for (; pos_ != end_; ++pos_) {
+      using buffer_type = std::conditional_t<std::is_const_v<value_type>, boost::asio::const_buffer,
+                                             boost::asio::mutable_buffer>;
+
+      buffer_type const buf = *pos_;
+      if (buf.size() > 0) {
+        chunk_ = span<value_type>(static_cast<value_type*>(buf.data()), buf.size());
+        ++pos_;
+        return;
+      }
+    }
+
+    chunk_ = {};
+  }
+
+ public:
+  buffer_cursor()                     = delete;
+  buffer_cursor(buffer_cursor const&) = default;
+  buffer_cursor(buffer_cursor&&)      = default;
+
+  explicit buffer_cursor(BufferSequence const& buf_seq)
+      : pos_{boost::asio::buffer_sequence_begin(buf_seq)}
+      , end_{boost::asio::buffer_sequence_end(buf_seq)}
+  {
+    next_chunk();
+  }
+
+  // the unconsumed remainder of the current segment
+  //
+  auto chunk() const noexcept -> span<value_type>
+  {
+    return chunk_;
+  }
+
+  auto empty() const noexcept -> bool
+  {
+    return chunk_.empty();
+  }
+
+  // the total number of octets advanced over so far
+  //
+  auto consumed() const noexcept -> usize
+  {
+    return consumed_;
+  }
+
+  // consumes `n` octets of the current chunk, moving on to the next non-empty segment once it's used up
+  //
+  auto advance(usize const n) -> void
+  {
+    BOOST_ASSERT(n <= chunk_.size());
+
+    consumed_ += n;
+    chunk_ = chunk_.subspan(n);
+    if (chunk_.empty()) { next_chunk(); }
+  }
+};
+
+template <class BufferSequence>
+buffer_cursor(BufferSequence const&) -> buffer_cursor<BufferSequence>;
+
+}    // namespace potok
+
+#endif    // POTOK_BUFFER_CURSOR_HPP_
@@ -0,0 +1,61 @@
+#ifndef POTOK_CPU_HPP_
+#define POTOK_CPU_HPP_
+
+#include <potok/stdint.hpp>
+
+// with GCC and Clang on x86 every SIMD variant of a kernel is compiled, each with its own target attribute, and the
+// one to run is picked at runtime so that a single binary can be deployed across CPU generations
+//
+// other compilers and architectures only get the variants the compiler flags already allow
+//
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define POTOK_X86_DISPATCH 1
+#define POTOK_TARGET(isa) __attribute__((target(isa)))
+#else
+#define POTOK_X86_DISPATCH 0
+#define POTOK_TARGET(isa)
+#endif
+
+#if POTOK_X86_DISPATCH || defined(__SSE2__) || defined(_M_X64)
+#define POTOK_HAS_SSE2 1
+#else
+#define POTOK_HAS_SSE2 0
+#endif
+
+#if POTOK_X86_DISPATCH || defined(__SSSE3__) || defined(__AVX2__)
+#define POTOK_HAS_SSSE3 1
+#else
+#define POTOK_HAS_SSSE3 0
+#endif
+
+#if POTOK_X86_DISPATCH || (defined(__AVX2__) && defined(__BMI2__))
+#define POTOK_HAS_AVX2 1
+#else
+#define POTOK_HAS_AVX2 0
+#endif
+
+namespace potok {
+
+// the tiers of SIMD support our kernels are written against, each one implying those before it
+//
+// `avx2` also requires BMI2, which every CPU shipping AVX2 so far has had
+//
+enum class cpu_level : u8 {
+  scalar,
+  sse2,
+  ssse3,
+  avx2
+};
+
+// the highest level both the CPU we're running on and the build support, detected once
+//
+auto detect_cpu_level() -> cpu_level;
+
+// whether BMI2's pext and pdep run in hardware, which is true of every CPU with BMI2 except AMD's (and Hygon's) before
+// Zen 3, where they're microcoded and take hundreds of cycles
+//
+auto has_fast_pext() -> bool;
+
+}    // namespace potok
+
+#endif    // POTOK_CPU_HPP_
@@ -0,0 +1,177 @@
+#ifndef POTOK_HPACK_BLOCK_DECODER_HPP_
+#define POTOK_HPACK_BLOCK_DECODER_HPP_
+
+#include <potok/hpack/decode.hpp>
+#include <potok/hpack/dynamic_table.hpp>
+#include <potok/hpack/error.hpp>
+#include <potok/hpack/header_field.hpp>
+#include <potok/hpack/huffman.hpp>
+#include <potok/hpack/representation.hpp>
+
+#include <potok/buffer_cursor.hpp>
+#include <potok/span.hpp>
+#include <potok/stdint.hpp>
+
+#include <boost/asio/buffer.hpp>
+
+#include <boost/system/error_code.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace potok {
+namespace hpack {
+
+// the longest string literal `block_decoder` accepts by default, before Huffman decoding
+//
+constexpr usize const default_max_string_size = 64 * 1024;
+
+// turns the header block fragments of HEADERS, PUSH_PROMISE and CONTINUATION frames into header fields, keeping the
+// dynamic table up to date along the way
+//
+// like the other decoders it's resumable: fragments are fed in as they arrive, as any ConstBufferSequence, and a field
+// split across them is picked up where it left off
+//
+// decoded fields are handed to a callback as views, which are only valid for the duration of the call:
+//   - indexed names and values refer to the static or the dynamic table
+//   - raw string literals that lie entirely within one buffer of the sequence refer to the input itself, so that the
+//     common case of indexed and raw fields doesn't copy anything
+//   - Huffman-coded string literals, and raw ones split across buffers, refer to scratch buffers owned by the decoder
+//     that are reused from one field to the next
+//
+// characters RFC 9113 forbids in field names and values are only rejected if `validate_fields` is set, in which case
+// Huffman-coded literals are checked as they're decoded and raw ones once they're complete
+//
+// any error is a connection error of type COMPRESSION_ERROR and leaves the decoder in an unspecified state
+//
+// see: https://datatracker.ietf.org/doc/html/rfc7541#section-3
+//
+class block_decoder {
+ public:
+  block_decoder(block_decoder const&) = delete;
+  block_decoder(block_decoder&&)      = default;
+
+  // `max_table_size` is the SETTINGS_HEADER_TABLE_SIZE we advertise, which bounds the dynamic table size updates the
+  // peer may send, and `max_string_size` bounds the length of each string literal
+  //
+  // `lookup` picks the table layout Huffman-coded literals are decoded with, and `validate_fields` has names and values
+  // checked with `huffman_validation::field_name` and `huffman_validation::field_value` respectively, failing with
+  // `error::invalid_field_name` or `error::invalid_field_value`
+  //
+  explicit block_decoder(usize const          max_table_size  = default_max_table_size,
+                         usize const          max_string_size = default_max_string_size,
+                         huffman_lookup const lookup          = huffman_lookup::single_symbol,
+                         bool const           validate_fields = false)
+      : table_(max_table_size)
+      , max_table_size_{max_table_size}
+      , max_string_size_{max_string_size}
+      , lookup_{lookup}
+      , validate_fields_{validate_fields}
+  {
+  }
+
+  // decodes as much of the header block as `const_buf_seq` holds, invoking `handler` with each complete
+  // `header_field const&`
+  //
+  // returns the number of octets consumed, which is all of them unless an error occurs
+  //
+  template <class ConstBufferSequence,
+            class FieldHandler,
+            std::enable_if_t<boost::asio::is_const_buffer_sequence<ConstBufferSequence>::value, int> = 0>
+  auto operator()(ConstBufferSequence        const_buf_seq,    //
+                  FieldHandler&&             handler,          //
+                  boost::system::error_code& ec) -> usize
+  {
+    using handler_type = std::remove_reference_t<FieldHandler>;
+
+    auto const on_field = [](void* const ctx, header_field const& field) {
+      (*static_cast<handler_type*>(ctx))(field);
+    };
+
+    auto* const ctx = const_cast<void*>(static_cast<void const*>(std::addressof(handler)));
+
+    ec = {};
+
+    auto cursor = buffer_cursor(const_buf_seq);
+    while (!cursor.empty()) {
+      auto const chunk = cursor.chunk();
+      cursor.advance(decode(chunk, on_field, ctx, ec));
+      if (ec) { break; }
+    }
+
+    return cursor.consumed();
+  }
+
+  template <class FieldHandler, std::size_t Extent>
+  auto operator()(span<u8 const, Extent> const octets,     //
+                  FieldHandler&&               handler,    //
+                  boost::system::error_code&   ec) -> usize
+  {
+    return (*this)(boost::asio::const_buffer(octets.data(), octets.size()), std::forward<FieldHandler>(handler), ec);
+  }
+
+  // marks the end of the header block, i.e. the frame with END_HEADERS has been decoded, failing with
+  // `error::incomplete_header_block` if it stopped partway through a field
+  //
+  auto finish(boost::system::error_code& ec) -> void;
+
+  // for when we advertise a new SETTINGS_HEADER_TABLE_SIZE, the table itself only changes once the peer acknowledges it
+  // with a dynamic table size update
+  //
+  auto set_max_table_size(usize const max_table_size) -> void
+  {
+    max_table_size_ = max_table_size;
+  }
+
+  auto table() const noexcept -> dynamic_table const&
+  {
+    return table_;
+  }
+
+ private:
+  enum class state { field_start, integer, name_length, name, value_length, value };
+
+  using field_callback = void (*)(void* ctx, header_field const& field);
+
+  dynamic_table                  table_;
+  usize                          max_table_size_  = 0;
+  usize                          max_string_size_ = 0;
+  huffman_lookup                 lookup_          = huffman_lookup::single_symbol;
+  bool                           validate_fields_ = false;
+  state                          state_           = state::field_start;
+  representation                 kind_            = representation::indexed;
+  std::optional<integer_decoder> integer_;
+  std::optional<huffman_decoder> huffman_;
+  bool                           huffman_coded_ = false;
+  usize                          string_size_   = 0;
+  usize                          string_pos_    = 0;
+  usize                          num_decoded_   = 0;
+  header_field                   field_;
+  bool                           name_in_input_ = false;
+  bool                           block_started_ = false;
+  std::string                    name_buf_;
+  std::string                    value_buf_;
+
+  auto decode(span<u8 const> chunk, field_callback on_field, void* ctx, boost::system::error_code& ec) -> usize;
+
+  auto lookup(u64 index, header_field& field, boost::system::error_code& ec) const -> bool;
+
+  auto apply_integer(u64 v, field_callback on_field, void* ctx, boost::system::error_code& ec) -> bool;
+
+  // what the string literal being decoded, a name or a value, is checked against
+  //
+  auto validation() const noexcept -> huffman_validation;
+
+  auto read_string(u8 const*& pos, u8 const* end, std::string& buf, std::string_view& str,
+                   boost::system::error_code& ec) -> bool;
+};
+
+}    // namespace hpack
+}    // namespace potok
+
+#endif    // POTOK_HPACK_BLOCK_DECODER_HPP_
@@ -0,0 +1,199 @@
+#ifndef POTOK_HPACK_BLOCK_ENCODER_HPP_
+#define POTOK_HPACK_BLOCK_ENCODER_HPP_
+
+#include <potok/hpack/dynamic_table.hpp>
+#include <potok/hpack/encoder_table.hpp>
+#include <potok/hpack/error.hpp>
+#include <potok/hpack/header_field.hpp>
+#include <potok/hpack/static_table.hpp>
+
+#include <potok/buffer_cursor.hpp>
+#include <potok/span.hpp>
+#include <potok/stdint.hpp>
+
+#include <boost/asio/buffer.hpp>
+
+#include <boost/system/error_code.hpp>
+
+#include <array>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace potok {
+namespace hpack {
+
+// how an indexing policy wants a header field to be sent, see `block_encoder`
+//
+enum class indexing {
+  // as an index if the field is in one of the tables, otherwise as a literal that's added to the dynamic table
+  //
+  incremental,
+  // as an index if the field is in one of the tables, otherwise as a literal that leaves the dynamic table alone
+  //
+  without,
+  // as a literal that intermediaries must not index either, only ever reusing an indexed name
+  //
+  never
+};
+
+// the default policy, tuned for server responses:
+//   - sensitive fields and credentials are never indexed, as suggested by
+//     https://datatracker.ietf.org/doc/html/rfc7541#section-7.1.3
+//   - fields whose values rarely repeat from one response to the next (content-length, etag, set-cookie, ...) and
+//     fields too large to share the table with anything else are sent without indexing
+//   - everything else, typically :status, content-type, server, cache-control and the like, is indexed
+//
+struct response_indexing_policy {
+  auto operator()(header_field const& field, dynamic_table const& table) const -> indexing;
+};
+
+// never adds anything to the dynamic table, trading compression for not having to maintain it
+//
+// fields are still looked up in the static table and in a dynamic table that's empty, which is next to free
+//
+struct static_only_indexing_policy {
+  auto operator()(header_field const& field, dynamic_table const& table) const -> indexing;
+};
+
+namespace detail {
+
+// everything about `block_encoder` that doesn't depend on its policy
+//
+class block_encoder_base {
+ public:
+  block_encoder_base(block_encoder_base const&) = delete;
+  block_encoder_base(block_encoder_base&&)      = default;
+
+  auto table() const noexcept -> dynamic_table const&
+  {
+    return table_.table();
+  }
+
+  // changes the size of the dynamic table to any value up to the peer's SETTINGS_HEADER_TABLE_SIZE, which is signalled
+  // at the start of the next header block
+  //
+  // the smallest of several sizes set in between two header blocks is signalled too, so that the peer evicts the same
+  // entries as we do
+  //
+  // see: https://datatracker.ietf.org/doc/html/rfc7541#section-4.2
+  //
+  auto set_max_table_size(usize max_table_size) -> void;
+
+  // marks the end of the header block, after which the next field starts a new one
+  //
+  // every octet of the block must have been written out by then
+  //
+  auto finish() -> void;
+
+ protected:
+  explicit block_encoder_base(usize const max_table_size)
+      : table_(max_table_size)
+  {
+  }
+
+  // writes as many of the octets left over from the previous field as fit in `out`
+  //
+  auto flush(span<u8> out) -> usize;
+
+  auto has_pending() const noexcept -> bool
+  {
+    return pending_pos_ < pending_.size();
+  }
+
+  // resizes the dynamic table as set since the previous header block if the next field starts a new one, so that the
+  // indexing policy sees the table the field is encoded against
+  //
+  // the size updates themselves are written out ahead of that field
+  //
+  auto start_field() -> void;
+
+  // encodes `field`, preceded by any size updates `start_field` left to write, as much of it as fits into `out` and the
+  // rest into a buffer for `flush`
+  //
+  // the dynamic table is updated right away so the field counts as encoded either way
+  //
+  auto encode_field(header_field const& field, indexing how, span<u8> out) -> usize;
+
+ private:
+  encoder_table        table_;
+  std::vector<u8>      pending_;
+  usize                pending_pos_             = 0;
+  usize                smallest_max_table_size_ = 0;
+  usize                next_max_table_size_     = 0;
+  std::array<usize, 2> size_updates_            = {};
+  usize                num_size_updates_        = 0;
+  bool                 size_update_pending_     = false;
+  bool                 block_started_           = false;
+
+  auto find(header_field const& field) const -> table_match;
+};
+
+}    // namespace detail
+
+// serializes header lists into header block fragments, keeping the dynamic table up to date along the way
+//
+// the representation of each field is picked by `IndexingPolicy`, a callable with the signature
+//   auto (header_field const& field, dynamic_table const& table) -> indexing
+// which lets each deployment trade compression ratio against encoder CPU; string literals are Huffman-coded whenever
+// that makes them shorter
+//
+// names must already be lowercase, as required by https://datatracker.ietf.org/doc/html/rfc9113#section-8.2.1
+//
+template <class IndexingPolicy = response_indexing_policy>
+class block_encoder : public detail::block_encoder_base {
+ public:
+  // `max_table_size` is the size of the dynamic table both endpoints start out with, SETTINGS_HEADER_TABLE_SIZE unless
+  // the table was resized out-of-band
+  //
+  explicit block_encoder(usize const max_table_size = default_max_table_size, IndexingPolicy policy = {})
+      : block_encoder_base(max_table_size)
+      , policy_(std::move(policy))
+  {
+  }
+
+  // encodes as many of `fields` as fit into `mutable_buf_seq`, e.g. the payloads of a HEADERS frame and the
+  // CONTINUATION frames following it, after whatever was left over from the previous call
+  //
+  // a field that straddles the end of the buffer sequence is finished by the next call, so `error::needs_more` is
+  // reported until every octet of every field in `fields` has been written, and `num_encoded` is the number of fields
+  // that don't need to be passed in again
+  //
+  // returns the number of octets written
+  //
+  template <class MutableBufferSequence,
+            std::enable_if_t<boost::asio::is_mutable_buffer_sequence<MutableBufferSequence>::value, int> = 0>
+  auto operator()(span<header_field const>   fields,             //
+                  MutableBufferSequence      mutable_buf_seq,    //
+                  usize&                     num_encoded,        //
+                  boost::system::error_code& ec) -> usize
+  {
+    ec          = {};
+    num_encoded = 0;
+
+    auto cursor = buffer_cursor(mutable_buf_seq);
+    while (!cursor.empty()) {
+      if (has_pending()) {
+        cursor.advance(flush(cursor.chunk()));
+        continue;
+      }
+
+      if (num_encoded == fields.size()) { break; }
+
+      auto const& field = fields[num_encoded++];
+      start_field();
+      cursor.advance(encode_field(field, policy_(field, table()), cursor.chunk()));
+    }
+
+    if (has_pending() || num_encoded < fields.size()) { ec = error::needs_more; }
+    return cursor.consumed();
+  }
+
+ private:
+  IndexingPolicy policy_;
+};
+
+}    // namespace hpack
+}    // namespace potok
+
+#endif    // POTOK_HPACK_BLOCK_ENCODER_HPP_
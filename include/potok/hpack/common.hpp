@@ -1,23 +1,49 @@
 #ifndef POTOK_HPACK_COMMON_HPP_
 #define POTOK_HPACK_COMMON_HPP_
 
+#include <potok/bit.hpp>
 #include <potok/stdint.hpp>
 
+#include <array>
+
 namespace potok {
 namespace hpack {
 
+namespace detail {
+
+// the number of octets needed for the continuation part of an integer encoding, indexed by the bit width of
+// I = (x - max_prefix_value), plus 1 for the prefix octet itself
+//
+// every continuation octet carries 7 bits of I and even I == 0 needs a single (empty) continuation octet
+//
+constexpr auto make_integer_octets_table()
+{
+  auto table = std::array<u8, 65>{};
+  for (usize bit_width = 0; bit_width < table.size(); ++bit_width) {
+    auto const num_continuation_octets = bit_width == 0 ? 1 : (bit_width + 6) / 7;
+    table[bit_width]                   = static_cast<u8>(1 + num_continuation_octets);
+  }
+  return table;
+}
+
+constexpr auto const integer_octets_by_bit_width = make_integer_octets_table();
+
+}    // namespace detail
+
 // to get the required number of octets to encode an integer, we first check if the supplied value fits inside the
 // prefix
 //
 // assuming it does, we know we can immediately return a value of 1
 //
 // if it does not, we know from the pseudocode algorithm that we need a number of octets N such that:
-//     128^N >= (x - max_prefix_value)
+//     128^N > (x - max_prefix_value)
 // is true, minimizing for N
 //
-// solving the above exponential would be mathematically equivalent to:
-//     floor(log(x - max_prefix_value) / log(128))
-// so we use an inline while-loop as that's likely faster than a `std::log` or `log` call
+// this is just the number of 7-bit groups needed to hold (x - max_prefix_value) so rather than dividing by 128 in a
+// loop, we compute its bit width with a single count-leading-zeros and look the answer up in a table
+//
+// or-ing in the low bit keeps the input to `countl_zero` non-zero without changing the result as widths 0 and 1 both
+// require a single continuation octet
 //
 constexpr auto get_num_required_octets(u64 const x, u8 const num_prefix_bits) -> u32
 {
@@ -25,15 +51,8 @@ constexpr auto get_num_required_octets(u64 const x, u8 const num_prefix_bits) ->
 
   if (x < max_prefix_value) { return 1; }
 
-  auto I = x - max_prefix_value;
-
-  auto count = 1;
-  while (I >= 128) {
-    ++count;
-    I /= 128;
-  }
-  ++count;
-  return count;
+  auto const bit_width = 64 - countl_zero((x - max_prefix_value) | 1);
+  return detail::integer_octets_by_bit_width[bit_width];
 }
 
 constexpr auto get_max_prefix_value(u8 const num_prefix_bits)
@@ -41,6 +60,11 @@ constexpr auto get_max_prefix_value(u8 const num_prefix_bits)
   return (u64{1} << num_prefix_bits) - 1;
 }
 
+// the longest valid encoding of a u64, which happens with a 1-bit prefix: the prefix octet followed by 10 continuation
+// octets carrying 7 bits each
+//
+constexpr usize const max_integer_octets = 11;
+
 }    // namespace hpack
 }    // namespace potok
 
@@ -3,19 +3,133 @@
 
 #include <potok/hpack/common.hpp>
 #include <potok/hpack/error.hpp>
+#include <potok/hpack/kernels.hpp>
 
+#include <potok/bit.hpp>
+#include <potok/buffer_cursor.hpp>
+#include <potok/cpu.hpp>
+#include <potok/span.hpp>
 #include <potok/stdint.hpp>
 
 #include <boost/asio/buffer.hpp>
-#include <boost/asio/buffers_iterator.hpp>
 
 #include <boost/system/error_code.hpp>
 
 #include <boost/assert.hpp>
 
+#include <boost/endian/conversion.hpp>
+
+#include <cstddef>
+#include <type_traits>
+
 namespace potok {
 namespace hpack {
 
+namespace detail {
+
+// whether adding the 7-bit group `bits` at bit offset `M` to `v` would exceed the range of a u64
+//
+constexpr auto integer_overflows(u64 const v, u64 const bits, u64 const M) -> bool
+{
+  if (M >= 64) { return bits != 0; }
+  return bits > ((~u64{0} - v) >> M);
+}
+
+constexpr auto const continuation_bits = u64{0x8080808080808080};
+
+// clears everything past the terminating octet among the 8 continuation octets in `w`, if there is one, along with
+// their continuation bits
+//
+// returns the number of continuation octets in `w`, 0 meaning that all 8 of them carry on
+//
+inline auto mask_continuation(u64& w) -> usize
+{
+  auto const stop_bits = ~w & continuation_bits;
+  if (stop_bits == 0) {
+    w &= ~continuation_bits;
+    return 0;
+  }
+
+  auto const num_bits = countr_zero(stop_bits) + 1;
+  if (num_bits < 64) { w &= (u64{1} << num_bits) - 1; }
+
+  w &= ~continuation_bits;
+  return num_bits / 8;
+}
+
+// the 9th and 10th continuation octets, once the first 8 (at most 56 bits, which can't overflow when added to the
+// prefix) have been added to `v`
+//
+inline auto decode_continuation_tail(u8 const* const pos, u64& v) -> usize
+{
+  auto const B8 = u64{pos[8]};
+  v += (B8 & 127) << 56;
+  if ((B8 & 128) == 0) { return 9; }
+
+  auto const B9 = u64{pos[9]};
+  if ((B9 & 128) == 128 || integer_overflows(v, B9 & 127, 63)) { return 0; }
+
+  v += (B9 & 127) << 63;
+  return 10;
+}
+
+// the first 8 continuation octets are loaded as one little-endian word: the terminating octet is the lowest one with a
+// clear high bit and the 7-bit groups are then compacted in log2(8) shift-and-mask steps
+//
+inline auto decode_integer_continuation_scalar(u8 const* const pos, u64& v) -> usize
+{
+  auto       w          = boost::endian::load_little_u64(pos);
+  auto const num_octets = mask_continuation(w);
+
+  w = (w & u64{0x007f007f007f007f}) | ((w & u64{0x7f007f007f007f00}) >> 1);
+  w = (w & u64{0x00003fff00003fff}) | ((w & u64{0x3fff00003fff0000}) >> 2);
+  w = (w & u64{0x000000000fffffff}) | ((w & u64{0x0fffffff00000000}) >> 4);
+
+  v += w;
+  return (num_octets != 0) ? num_octets : decode_continuation_tail(pos, v);
+}
+
+#if POTOK_HAS_AVX2
+
+// as above, but the 7-bit groups are compacted by a single BMI2 pext
+//
+auto decode_integer_continuation_bmi2(u8 const* pos, u64& v) -> usize;
+
+// whether `decode_integer_unrolled` calls `decode_integer_continuation_bmi2`, set once at startup and by
+// `force_cpu_level`
+//
+// only CPUs that run pext in hardware get it, see `has_fast_pext`, and even then it only saves a handful of ALU ops
+// over the inlined scalar code, so it's a direct call behind a flag rather than a call through `active_kernels()`
+//
+extern bool use_pext;
+
+#endif
+
+// decodes a prefix integer starting at `pos`, which must be followed by at least `max_integer_octets` readable octets
+// so that no bounds checks are required
+//
+// returns the number of octets consumed or 0 if the encoding doesn't fit in a u64, in value or in length
+//
+inline auto decode_integer_unrolled(u8 const* const pos, u8 const num_prefix_bits, u64& v) -> usize
+{
+  auto const max_prefix_value = get_max_prefix_value(num_prefix_bits);
+
+  v = pos[0] & max_prefix_value;
+  if (v < max_prefix_value) { return 1; }
+
+#if POTOK_HAS_AVX2
+  if (use_pext) {
+    auto const n = decode_integer_continuation_bmi2(pos + 1, v);
+    return (n == 0) ? 0 : 1 + n;
+  }
+#endif
+
+  auto const n = decode_integer_continuation_scalar(pos + 1, v);
+  return (n == 0) ? 0 : 1 + n;
+}
+
+}    // namespace detail
+
 //  decode I from the next N bits
 //  if I < 2^N - 1, return I
 //  else
@@ -30,10 +144,12 @@ namespace hpack {
 struct integer_decoder {
   enum class state { first, continuation, final, done };
 
-  u64      v_               = 0;
-  u64      M_               = 0;
-  state    state_           = state::first;
-  u8 const num_prefix_bits_ = 0;
+  u64       v_               = 0;
+  u64       M_               = 0;
+  u64 const max_value_       = ~u64{0};
+  u32 const max_octets_      = max_integer_octets;
+  state     state_           = state::first;
+  u8 const  num_prefix_bits_ = 0;
 
   integer_decoder()                       = delete;
   integer_decoder(integer_decoder const&) = default;
@@ -45,24 +161,86 @@ struct integer_decoder {
     BOOST_ASSERT(num_prefix_bits_ >= 1 && num_prefix_bits_ <= 8);
   }
 
-  template <class ConstBufferSequence>
+  // bounds the decoded value by `max_value`, e.g. the current dynamic table size or the maximum header list size
+  //
+  // decoding fails with `error::limit_exceeded` as soon as the partial value exceeds the bound or the encoding becomes
+  // longer than the shortest encoding of `max_value`, so a peer can't make us consume arbitrarily long continuation runs
+  // only to reject the value at the end
+  //
+  integer_decoder(u8 const num_prefix_bits, u64 const max_value)
+      : max_value_{max_value}
+      , max_octets_{get_num_required_octets(max_value, num_prefix_bits)}
+      , num_prefix_bits_{num_prefix_bits}
+  {
+    BOOST_ASSERT(num_prefix_bits_ >= 1 && num_prefix_bits_ <= 8);
+  }
+
+  // for when the prefix octet has already been consumed by the caller, e.g. via `classify_field`, and was found to
+  // have all of its prefix bits set so that continuation octets follow
+  //
+  auto skip_prefix() -> void
+  {
+    BOOST_ASSERT(state_ == state::first);
+
+    v_     = get_max_prefix_value(num_prefix_bits_);
+    state_ = state::continuation;
+  }
+
+  template <class ConstBufferSequence,
+            std::enable_if_t<boost::asio::is_const_buffer_sequence<ConstBufferSequence>::value, int> = 0>
   auto operator()(ConstBufferSequence        const_buf_seq,    //
                   u64&                       v,                //
                   boost::system::error_code& ec) -> usize
   {
-    constexpr auto const u64_max = u64{0xffffffff};
+    // the state machine is resumable so the segments are decoded one after another, each as a plain pointer range,
+    // until the integer is complete or the sequence runs dry
+    //
+    auto cursor = buffer_cursor(const_buf_seq);
+    if (cursor.empty()) { return decode(nullptr, nullptr, v, ec); }
+
+    do {
+      auto const chunk = cursor.chunk();
+      cursor.advance(decode(chunk.data(), chunk.data() + chunk.size(), v, ec));
+    } while (ec == error::needs_more && !cursor.empty());
+
+    return cursor.consumed();
+  }
+
+  template <std::size_t Extent>
+  auto operator()(span<u8 const, Extent> const octets,    //
+                  u64&                         v,         //
+                  boost::system::error_code&   ec) -> usize
+  {
+    return decode(octets.data(), octets.data() + octets.size(), v, ec);
+  }
+
+ private:
+  auto decode(u8 const* pos, u8 const* const end, u64& v, boost::system::error_code& ec) -> usize
+  {
+    ec = {};
 
     auto bytes_read = usize{0};
     if (state_ == state::done) { return bytes_read; }
 
-    auto pos = boost::asio::buffers_begin(const_buf_seq);
-    auto end = boost::asio::buffers_end(const_buf_seq);
-
     if (pos == end) {
       ec = error::needs_more;
       return bytes_read;
     }
 
+    // only near the end of a buffer do we need the resumable state machine, otherwise the whole integer is known to be
+    // in range and can be decoded without any per-octet bounds checks
+    //
+    // rejected encodings are re-run through the state machine which stops at the exact offending octet
+    //
+    if (state_ == state::first && static_cast<usize>(end - pos) >= max_integer_octets) {
+      auto const n = detail::decode_integer_unrolled(pos, num_prefix_bits_, v_);
+      if (n != 0 && n <= max_octets_ && v_ <= max_value_) {
+        state_ = state::done;
+        v      = v_;
+        return n;
+      }
+    }
+
     switch (state_) {
       case state::first: {
         auto const max_prefix_value = get_max_prefix_value(num_prefix_bits_);
@@ -70,6 +248,11 @@ struct integer_decoder {
         v_ = *pos++ & max_prefix_value;
         ++bytes_read;
 
+        if (v_ > max_value_) {
+          ec = error::limit_exceeded;
+          break;
+        }
+
         if (v_ < max_prefix_value) {
           state_ = state::done;
           break;
@@ -83,16 +266,32 @@ struct integer_decoder {
         for (; (pos != end) && ((B & 128) == 128); ++pos, ++bytes_read, M_ += 7) {
           B = *pos;
 
-          auto const tmp = (B & u64{127}) * (u64{1} << M_);
-          if (v_ > u64_max - tmp) {
+          // the prefix octet plus one octet per 7 bits already gathered
+          //
+          auto const num_octets = 2 + M_ / 7;
+          if (num_octets > max_octets_) {
+            ec = (max_octets_ == max_integer_octets) ? error::too_large : error::limit_exceeded;
+            ++bytes_read;
+            break;
+          }
+
+          if (detail::integer_overflows(v_, B & u64{127}, M_)) {
             ec = error::too_large;
+            ++bytes_read;
             break;
           }
 
-          v_ += tmp;
+          v_ += (B & u64{127}) << M_;
+          if (v_ > max_value_) {
+            ec = error::limit_exceeded;
+            ++bytes_read;
+            break;
+          }
         }
 
-        if (!ec && ((B & 128) == 128)) {
+        if (ec) { break; }
+
+        if ((B & 128) == 128) {
           BOOST_ASSERT(pos == end);
           ec = error::needs_more;
           break;
@@ -112,45 +311,47 @@ struct integer_decoder {
 };
 
 template <class ConstBufferSequence>
-auto decode_integer(u8 const            num_prefix_bits,    //
-                    ConstBufferSequence const_buf_seq,      //
-                    u64&                out,                //
-                    boost::system::error_code&) -> usize
+auto decode_integer(u8 const                   num_prefix_bits,    //
+                    ConstBufferSequence        const_buf_seq,      //
+                    u64&                       out,                //
+                    boost::system::error_code& ec) -> usize
 {
-  BOOST_ASSERT(num_prefix_bits >= 1 && num_prefix_bits <= 8);
-
-  auto pos = boost::asio::buffers_begin(const_buf_seq);
-  auto end = boost::asio::buffers_end(const_buf_seq);
-
-  u64 const max_prefix_value = get_max_prefix_value(num_prefix_bits);
+  auto d = integer_decoder(num_prefix_bits);
+  return d(const_buf_seq, out, ec);
+}
 
-  auto num_parsed = u64{0};
+// after warm-up most header blocks consist largely of runs of indexed header fields whose index fits in the 7-bit
+// prefix, i.e. single octets in the range [0x81, 0xfe]
+//
+// `decode_indexed_run` finds the run at the start of `octets` several octets at a time (SSE2/AVX2/NEON, picked at
+// runtime where possible) and writes the decoded indices to `indices`
+//
+// the run ends at the first octet that isn't a complete single-octet indexed field, including 0x80 (index 0) which is a
+// decoding error that's left to the regular field decoder to report
+//
+// returns the length of the run, which is bounded by the size of both spans
+//
+auto decode_indexed_run(span<u8 const> octets, span<u8> indices) -> usize;
 
-  auto I = *pos & max_prefix_value;
-  ++num_parsed;
+namespace detail {
 
-  if (I < max_prefix_value) {
-    out = I;
-    return num_parsed;
-  }
+auto decode_indexed_run_scalar(span<u8 const> octets, span<u8> indices) -> usize;
 
-  auto M = u64{0};
-  ++pos;
+#if POTOK_HAS_SSE2
+auto decode_indexed_run_sse2(span<u8 const> octets, span<u8> indices) -> usize;
+#endif
 
-  auto B = u64{128};
-  while ((pos != end) && ((B & 128) == 128)) {
-    B = *pos++;
-    I = I + (B & u64{127}) * (u64{1} << M);
-    M += 7;
-    ++num_parsed;
-  }
+#if POTOK_HAS_AVX2
+auto decode_indexed_run_avx2(span<u8 const> octets, span<u8> indices) -> usize;
+#endif
 
-  out = I;
+#if defined(__ARM_NEON)
+auto decode_indexed_run_neon(span<u8 const> octets, span<u8> indices) -> usize;
+#endif
 
-  return num_parsed;
-}
+}    // namespace detail
 
 }    // namespace hpack
 }    // namespace potok
 
-#endif    // POTOK_HPACK_ENCODE_HPP_
\ No newline at end of file
+#endif    // POTOK_HPACK_DECODE_HPP_
\ No newline at end of file
@@ -0,0 +1,118 @@
+#ifndef POTOK_HPACK_DYNAMIC_TABLE_HPP_
+#define POTOK_HPACK_DYNAMIC_TABLE_HPP_
+
+#include <potok/hpack/header_field.hpp>
+
+#include <potok/stdint.hpp>
+
+#include <boost/assert.hpp>
+
+#include <string_view>
+#include <vector>
+
+namespace potok {
+namespace hpack {
+
+// the initial value of SETTINGS_HEADER_TABLE_SIZE
+//
+// see: https://datatracker.ietf.org/doc/html/rfc9113#section-6.5.2
+//
+constexpr usize const default_max_table_size = 4096;
+
+// the dynamic table from https://datatracker.ietf.org/doc/html/rfc7541#section-2.3.2, a FIFO of header fields bounded
+// by the sum of their `entry_size`s
+//
+// entries are numbered from 0, the most recently inserted one, which is HPACK index `static_table_size + 1`
+//
+// the names and values live back to back in a single ring of `max_size` octets and the entries themselves in a ring of
+// offsets, both allocated up front, so that inserting is a copy into the ring, evicting is moving its tail along and
+// looking an entry up is a single masked load
+//
+// the 32 octets of overhead each entry is charged for guarantee that the live names and values always fit in the ring
+// with room to spare: an entry that runs past its end continues into a mirror region of another `max_size` octets
+// rather than wrapping around, so that every name and value is one contiguous view, and the next entry starts at the
+// beginning of the ring as far in as the previous one ran into the mirror
+//
+class dynamic_table {
+ public:
+  dynamic_table()
+      : dynamic_table(default_max_table_size)
+  {
+  }
+
+  explicit dynamic_table(usize max_size);
+
+  // the number of entries
+  //
+  auto size() const noexcept -> usize
+  {
+    return size_;
+  }
+
+  // the size of the table as defined by HPACK, which is what `max_size` bounds
+  //
+  auto num_octets() const noexcept -> usize
+  {
+    return num_octets_;
+  }
+
+  auto max_size() const noexcept -> usize
+  {
+    return max_size_;
+  }
+
+  // the views remain valid until the next call to `insert` or `set_max_size`
+  //
+  auto operator[](usize const i) const noexcept -> header_field
+  {
+    BOOST_ASSERT(i < size_);
+
+    auto const& e    = entries_[(first_ + size_ - 1 - i) & entry_mask_];
+    auto const* name = bytes_.data() + e.offset;
+    return {std::string_view(name, e.name_size), std::string_view(name + e.name_size, e.value_size)};
+  }
+
+  // evicts the oldest entries until the table fits in `max_size`
+  //
+  // growing the table past the largest size it has had so far reallocates the rings, shrinking it never does
+  //
+  auto set_max_size(usize max_size) -> void;
+
+  // adds a copy of `name` and `value` as entry 0, evicting the oldest entries to make room
+  //
+  // `name` may refer to an entry of the table itself, even one that's about to be evicted, but `value` may not
+  //
+  // an entry larger than `max_size` empties the table without being added
+  //
+  auto insert(std::string_view name, std::string_view value) -> void;
+
+ private:
+  struct entry {
+    u32 offset     = 0;
+    u32 name_size  = 0;
+    u32 value_size = 0;
+  };
+
+  // the ring of names and values, `capacity_` octets followed by the mirror region
+  //
+  std::vector<char> bytes_;
+  // the ring of entries, a power of 2 in size
+  //
+  std::vector<entry> entries_;
+
+  usize capacity_   = 0;
+  usize head_       = 0;
+  usize first_      = 0;
+  usize size_       = 0;
+  usize entry_mask_ = 0;
+  usize num_octets_ = 0;
+  usize max_size_   = 0;
+
+  auto reserve(usize max_size) -> void;
+  auto evict_until(usize max_size) -> void;
+};
+
+}    // namespace hpack
+}    // namespace potok
+
+#endif    // POTOK_HPACK_DYNAMIC_TABLE_HPP_
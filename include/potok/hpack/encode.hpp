@@ -4,15 +4,17 @@
 #include <potok/hpack/common.hpp>
 #include <potok/hpack/error.hpp>
 
+#include <potok/buffer_cursor.hpp>
+#include <potok/span.hpp>
 #include <potok/stdint.hpp>
 
 #include <boost/asio/buffer.hpp>
-#include <boost/asio/buffers_iterator.hpp>
 
 #include <boost/assert.hpp>
 
 #include <boost/throw_exception.hpp>
 
+#include <array>
 #include <stdexcept>
 
 namespace potok {
@@ -50,8 +52,23 @@ struct integer_encoder {
   auto operator()(MutableBufferSequence      mutable_buf_seq,    //
                   boost::system::error_code& ec) -> usize
   {
-    auto pos = boost::asio::buffers_begin(mutable_buf_seq);
-    auto end = boost::asio::buffers_end(mutable_buf_seq);
+    // each segment is written as a plain pointer range, resuming the state machine in the next one as needed
+    //
+    auto cursor = buffer_cursor(mutable_buf_seq);
+    if (cursor.empty()) { return encode(nullptr, nullptr, ec); }
+
+    do {
+      auto const chunk = cursor.chunk();
+      cursor.advance(encode(chunk.data(), chunk.data() + chunk.size(), ec));
+    } while (ec == error::needs_more && !cursor.empty());
+
+    return cursor.consumed();
+  }
+
+ private:
+  auto encode(u8* pos, u8* const end, boost::system::error_code& ec) -> usize
+  {
+    ec = {};
 
     auto bytes_written = usize{0};
 
@@ -121,6 +138,62 @@ struct integer_encoder {
   }
 };
 
+// encodes `v` directly into `out`, which the caller has already sized using `get_num_required_octets`
+//
+// as there's no chance of running out of space, the octets are written in a single pass with no state to track and no
+// error to report
+//
+// like `integer_encoder`, the non-prefix bits of the leading octet are left untouched
+//
+// returns one past the last octet written
+//
+constexpr auto encode_integer(u64 v, u8 const num_prefix_bits, span<u8> const out) -> u8*
+{
+  BOOST_ASSERT(num_prefix_bits >= 1 && num_prefix_bits <= 8);
+  BOOST_ASSERT(out.size() >= get_num_required_octets(v, num_prefix_bits));
+
+  auto* pos = out.data();
+
+  auto const max_prefix_value = get_max_prefix_value(num_prefix_bits);
+  auto const flags            = static_cast<u8>(*pos & ~max_prefix_value);
+
+  if (v < max_prefix_value) {
+    *pos++ = static_cast<u8>(flags | v);
+    return pos;
+  }
+
+  *pos++ = static_cast<u8>(flags | max_prefix_value);
+  v -= max_prefix_value;
+
+  while (v >= 128) {
+    *pos++ = static_cast<u8>(v | 128);
+    v >>= 7;
+  }
+
+  *pos++ = static_cast<u8>(v);
+  return pos;
+}
+
+// encodes a value known at compile-time into an array of exactly `get_num_required_octets` octets
+//
+// constants we emit over and over (static table indices, common status codes, etc.) can then live in read-only storage
+// and be copied into the output as-is
+//
+// `Flags` supplies the non-prefix bits of the leading octet, e.g. the bit pattern of a header field representation
+//
+template <u64 Value, u8 NumPrefixBits, u8 Flags = 0>
+constexpr auto make_encoded_integer() -> std::array<u8, get_num_required_octets(Value, NumPrefixBits)>
+{
+  static_assert(NumPrefixBits >= 1 && NumPrefixBits <= 8);
+  static_assert((Flags & get_max_prefix_value(NumPrefixBits)) == 0, "Flags must not overlap the prefix bits");
+
+  auto octets = std::array<u8, get_num_required_octets(Value, NumPrefixBits)>{};
+  octets[0]   = Flags;
+
+  encode_integer(Value, NumPrefixBits, octets);
+  return octets;
+}
+
 }    // namespace hpack
 }    // namespace potok
 
@@ -0,0 +1,79 @@
+#ifndef POTOK_HPACK_ENCODER_TABLE_HPP_
+#define POTOK_HPACK_ENCODER_TABLE_HPP_
+
+#include <potok/hpack/dynamic_table.hpp>
+#include <potok/hpack/static_table.hpp>
+
+#include <potok/stdint.hpp>
+
+#include <string_view>
+#include <vector>
+
+namespace potok {
+namespace hpack {
+
+// the encoder's side of the dynamic table, along with hash indices over it keyed by name and by name and value so that
+// finding a field takes a couple of probes rather than a scan of the whole table
+//
+// every entry is identified by its absolute insertion count, its sequence number, rather than by its HPACK index,
+// which shifts with every insertion: the entry with sequence number `seq` is entry `num_inserted - 1 - seq` of the
+// table, so inserting an entry adds it to the indices and evicting one removes it without touching anything else
+//
+// each index keeps only the most recent entry for each key, which is the one with the lowest HPACK index, and a hash
+// collision at worst makes an older key unfindable, as every hit is checked against the table itself
+//
+class encoder_table {
+ public:
+  explicit encoder_table(usize max_size = default_max_table_size);
+
+  auto table() const noexcept -> dynamic_table const&
+  {
+    return table_;
+  }
+
+  auto set_max_size(usize max_size) -> void;
+
+  // see `dynamic_table::insert`
+  //
+  auto insert(std::string_view name, std::string_view value) -> void;
+
+  // looks `name` and `value` up in the dynamic table, preferring an entry that matches both over the most recent one
+  // that matches the name
+  //
+  // the returned index is the HPACK index, i.e. past the static table
+  //
+  auto find(std::string_view name, std::string_view value) const -> table_match;
+
+ private:
+  // an entry of one of the open-addressed indices, empty when `seq` is 0, which makes it 1 past the sequence number
+  //
+  struct slot {
+    u64 seq  = 0;
+    u32 hash = 0;
+  };
+
+  // the hashes of a live entry, needed to find its slots again once it's evicted
+  //
+  struct entry_hashes {
+    u32 name  = 0;
+    u32 field = 0;
+  };
+
+  dynamic_table             table_;
+  std::vector<slot>         names_;
+  std::vector<slot>         fields_;
+  std::vector<entry_hashes> hashes_;
+  usize                     slot_mask_    = 0;
+  u64                       num_inserted_ = 0;
+
+  auto reserve(usize max_size) -> void;
+  auto remove_evicted(usize num_before) -> void;
+  auto lookup(std::vector<slot> const& index, u32 hash) const -> u64;
+  auto store(std::vector<slot>& index, u32 hash, u64 seq) -> void;
+  auto erase(std::vector<slot>& index, u32 hash, u64 seq) -> void;
+};
+
+}    // namespace hpack
+}    // namespace potok
+
+#endif    // POTOK_HPACK_ENCODER_TABLE_HPP_
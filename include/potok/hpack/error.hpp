@@ -9,14 +9,49 @@
 namespace potok {
 namespace hpack {
 
+// values start at 1 as an error_code holding 0 is treated as success
+//
 enum class error : int {
   // the encoder/decoder need more octets to finish their operations
   //
-  needs_more,
+  needs_more = 1,
   // the ConstBufferSequence contains valid continuation bytes in the integer encoding but would exceed the 64-bit limit
   // imposed by the implementation
   //
-  too_large
+  too_large,
+  // the integer being decoded exceeds the maximum supplied by the caller, either in value or in encoded length
+  //
+  limit_exceeded,
+  // a Huffman-coded string literal contains the EOS symbol, which is a decoding error
+  //
+  // see: https://datatracker.ietf.org/doc/html/rfc7541#section-5.2
+  //
+  huffman_eos,
+  // a Huffman-coded string literal ends in 8 or more bits of padding
+  //
+  huffman_padding_too_long,
+  // a Huffman-coded string literal ends in padding that isn't the most significant bits of EOS, i.e. all ones, or in
+  // the incomplete code of some other symbol
+  //
+  huffman_invalid_padding,
+  // a field name contains a character forbidden by https://datatracker.ietf.org/doc/html/rfc9113#section-8.2.1, i.e.
+  // anything in 0x00-0x20, 0x41-0x5a (uppercase) or 0x7f-0xff
+  //
+  invalid_field_name,
+  // a field value contains NUL, CR or LF
+  //
+  invalid_field_value,
+  // a header field refers to index 0 or to an index past the end of the dynamic table
+  //
+  invalid_index,
+  // a dynamic table size update follows a header field, rather than being at the start of the header block
+  //
+  // see: https://datatracker.ietf.org/doc/html/rfc9113#section-4.3.1
+  //
+  unexpected_size_update,
+  // the header block ends partway through a header field
+  //
+  incomplete_header_block
 };
 
 struct hpack_error_category final : public boost::system::error_category {
@@ -31,6 +66,36 @@ struct hpack_error_category final : public boost::system::error_category {
       case error::needs_more:
         return "needs more";
 
+      case error::too_large:
+        return "integer exceeds the 64-bit limit";
+
+      case error::limit_exceeded:
+        return "integer exceeds the caller-supplied limit";
+
+      case error::huffman_eos:
+        return "Huffman-coded string literal contains EOS";
+
+      case error::huffman_padding_too_long:
+        return "Huffman-coded string literal has more than 7 bits of padding";
+
+      case error::huffman_invalid_padding:
+        return "Huffman-coded string literal has padding that isn't a prefix of EOS";
+
+      case error::invalid_field_name:
+        return "field name contains an invalid character";
+
+      case error::invalid_field_value:
+        return "field value contains an invalid character";
+
+      case error::invalid_index:
+        return "header field index is out of range";
+
+      case error::unexpected_size_update:
+        return "dynamic table size update after the start of the header block";
+
+      case error::incomplete_header_block:
+        return "header block ends partway through a header field";
+
       default:
         return "potok.hpack error";
     }
@@ -0,0 +1,41 @@
+#ifndef POTOK_HPACK_HEADER_FIELD_HPP_
+#define POTOK_HPACK_HEADER_FIELD_HPP_
+
+#include <potok/stdint.hpp>
+
+#include <string_view>
+
+namespace potok {
+namespace hpack {
+
+// a name-value pair as it goes into the encoder or comes out of the decoder
+//
+// the views refer to storage owned by someone else (the static table, the dynamic table, the decoder's input or its
+// scratch buffers), see the individual producers for how long they remain valid
+//
+struct header_field {
+  std::string_view name;
+  std::string_view value;
+  // the field was, or has to be, sent as a literal that's never indexed, which intermediaries must preserve when
+  // forwarding it
+  //
+  // see: https://datatracker.ietf.org/doc/html/rfc7541#section-6.2.3
+  //
+  bool sensitive = false;
+};
+
+// every dynamic table entry is charged 32 octets on top of its name and value for the bookkeeping
+//
+// see: https://datatracker.ietf.org/doc/html/rfc7541#section-4.1
+//
+constexpr usize const entry_overhead = 32;
+
+constexpr auto entry_size(std::string_view const name, std::string_view const value) -> usize
+{
+  return name.size() + value.size() + entry_overhead;
+}
+
+}    // namespace hpack
+}    // namespace potok
+
+#endif    // POTOK_HPACK_HEADER_FIELD_HPP_
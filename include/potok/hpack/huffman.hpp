@@ -0,0 +1,244 @@
+#ifndef POTOK_HPACK_HUFFMAN_HPP_
+#define POTOK_HPACK_HUFFMAN_HPP_
+
+#include <potok/hpack/error.hpp>
+
+#include <potok/buffer_cursor.hpp>
+#include <potok/cpu.hpp>
+#include <potok/span.hpp>
+#include <potok/stdint.hpp>
+
+#include <boost/asio/buffer.hpp>
+
+#include <boost/system/error_code.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <memory_resource>
+#include <string>
+#include <type_traits>
+
+namespace potok {
+namespace hpack {
+
+// the Huffman code from https://datatracker.ietf.org/doc/html/rfc7541#appendix-B
+//
+// its shortest codes are 5 bits long so `n` octets of Huffman-coded data can decode to at most 8n / 5 octets, rounded
+// down since a symbol needs all 5 of its bits
+//
+constexpr auto huffman_max_decoded_size(usize const encoded_size) -> usize
+{
+  return encoded_size * 8 / 5;
+}
+
+// the table layouts `decode_huffman` can use, which one is faster depends on the CPU and the input so see
+// tests/huffman_decode_benchmark.cpp
+//
+enum class huffman_lookup {
+  // one symbol per probe of a 2048-entry (4 KiB) table indexed by the next 11 bits, which covers nearly everything
+  // found in real header fields
+  //
+  single_symbol,
+  // every symbol that lies entirely within the next 12 bits, up to 3 of them, per probe of a 4096-entry (16 KiB) table
+  //
+  // the common header characters all have 5 to 7 bit codes so most probes yield 2 symbols
+  //
+  multi_symbol
+};
+
+// the characters a decoded string is checked against, in the same pass as the decoding itself
+//
+// see: https://datatracker.ietf.org/doc/html/rfc9113#section-8.2.1
+//
+enum class huffman_validation {
+  none,
+  // no controls, whitespace, uppercase letters or octets above 0x7e, failing with `error::invalid_field_name`
+  //
+  // the placement of a pseudo-header's colon is up to the caller
+  //
+  field_name,
+  // no NUL, CR or LF, failing with `error::invalid_field_value`
+  //
+  // leading and trailing whitespace is up to the caller since it depends on where in the value it is
+  //
+  field_value
+};
+
+// a resumable decoder for a single Huffman-coded string literal of `encoded_size` octets, the length taken from the
+// string literal's prefix
+//
+// like `integer_decoder`, the literal can be fed in as many pieces as it arrives in (socket reads, HEADERS and
+// CONTINUATION frames) as any ConstBufferSequence, without reassembling it first
+//
+// up to 63 bits of input are carried over between calls in a bit accumulator: a code split across two pieces is
+// finished once the next piece arrives
+//
+// `out` must be the unused part of a buffer of at least `huffman_max_decoded_size(encoded_size)` octets, which is what
+// lets the decoding loop go without capacity checks, and `num_written` reports how much of it this call filled in
+//
+// returns the number of octets consumed, which is never more than what remains of the literal so that whatever follows
+// it in the buffer sequence is left alone; `error::needs_more` is reported until the whole literal has been seen
+//
+// characters rejected by `validation` are reported as soon as the piece containing them has been decoded
+//
+struct huffman_decoder {
+  u64                      acc_        = 0;
+  u32                      num_bits_   = 0;
+  u32                      classes_    = 0;
+  usize                    remaining_  = 0;
+  bool                     done_       = false;
+  huffman_lookup const     lookup_     = huffman_lookup::single_symbol;
+  huffman_validation const validation_ = huffman_validation::none;
+
+  huffman_decoder()                       = delete;
+  huffman_decoder(huffman_decoder const&) = default;
+  huffman_decoder(huffman_decoder&&)      = default;
+
+  huffman_decoder(usize const              encoded_size,
+                  huffman_lookup const     lookup     = huffman_lookup::single_symbol,
+                  huffman_validation const validation = huffman_validation::none)
+      : remaining_{encoded_size}
+      , lookup_{lookup}
+      , validation_{validation}
+  {
+  }
+
+  template <class ConstBufferSequence,
+            std::enable_if_t<boost::asio::is_const_buffer_sequence<ConstBufferSequence>::value, int> = 0>
+  auto operator()(ConstBufferSequence        const_buf_seq,    //
+                  span<u8>                   out,              //
+                  usize&                     num_written,      //
+                  boost::system::error_code& ec) -> usize
+  {
+    ec          = {};
+    num_written = 0;
+    if (done_) { return 0; }
+
+    auto cursor = buffer_cursor(const_buf_seq);
+    while (remaining_ > 0 && !cursor.empty()) {
+      auto const chunk = cursor.chunk().first(std::min(cursor.chunk().size(), remaining_));
+
+      num_written += decode(chunk, out.subspan(num_written), ec);
+      cursor.advance(chunk.size());
+      if (ec) { return cursor.consumed(); }
+    }
+
+    if (remaining_ > 0) {
+      ec = error::needs_more;
+      return cursor.consumed();
+    }
+
+    // an empty literal never sees a chunk but still has to be finished
+    //
+    if (!done_) { num_written += decode({}, out.subspan(num_written), ec); }
+    return cursor.consumed();
+  }
+
+  template <std::size_t Extent>
+  auto operator()(span<u8 const, Extent> const encoded,        //
+                  span<u8>                     out,            //
+                  usize&                       num_written,    //
+                  boost::system::error_code&   ec) -> usize
+  {
+    return (*this)(boost::asio::const_buffer(encoded.data(), encoded.size()), out, num_written, ec);
+  }
+
+ private:
+  // decodes every complete symbol in the accumulator and `encoded`, which must not extend past the end of the literal,
+  // and validates the padding once the last octet has been seen
+  //
+  auto decode(span<u8 const> encoded, span<u8> out, boost::system::error_code& ec) -> usize;
+};
+
+// decodes the Huffman-coded string literal `encoded` in its entirety into `out`, which must be able to hold at least
+// `huffman_max_decoded_size(encoded.size())` octets
+//
+// codes that don't fit in the lookup table are decoded by a short search over the canonical code lengths
+//
+// fails with `error::huffman_eos` if the string contains the EOS symbol, `error::huffman_padding_too_long` or
+// `error::huffman_invalid_padding` if its trailing bits aren't valid padding, and with
+// `error::invalid_field_name`/`error::invalid_field_value` if `validation` asks for it
+//
+// returns the number of octets written to `out`
+//
+auto decode_huffman(span<u8 const>             encoded,    //
+                    span<u8>                   out,        //
+                    boost::system::error_code& ec,         //
+                    huffman_lookup             lookup     = huffman_lookup::single_symbol,    //
+                    huffman_validation         validation = huffman_validation::none) -> usize;
+
+// decodes `encoded` as above into a string that's allocated exactly once, up front, from `mr`
+//
+// the string is sized for `huffman_max_decoded_size(encoded.size())` octets and then shrunk to fit without
+// reallocating, so a per-connection arena can take all of the decoded literals without touching the general-purpose
+// heap
+//
+auto decode_huffman(span<u8 const>             encoded,    //
+                    std::pmr::memory_resource* mr,         //
+                    boost::system::error_code& ec,         //
+                    huffman_lookup             lookup     = huffman_lookup::single_symbol,    //
+                    huffman_validation         validation = huffman_validation::none) -> std::pmr::string;
+
+// the exact number of octets `encode_huffman` produces for `str`, padding included
+//
+// this lets the string literal's length be encoded before its payload without encoding the string twice or moving the
+// payload around afterwards
+//
+// the code lengths are looked up 16 or 32 octets at a time (SSSE3/AVX2, picked at runtime where possible), which keeps
+// the cost of deciding between a raw and a Huffman-coded literal well below the cost of the encoding itself
+//
+auto huffman_encoded_size(span<u8 const> str) -> usize;
+
+// whether Huffman-coding `str` makes for a shorter string literal than sending it as-is
+//
+// RFC 7541 leaves the choice to the encoder on a per-string basis, ties go to the raw form since it's cheaper to decode
+//
+auto huffman_is_shorter(span<u8 const> str) -> bool;
+
+// Huffman-codes `str` into `out`, which must be able to hold at least `huffman_encoded_size(str)` octets
+//
+// the final octet is padded with the most significant bits of EOS
+//
+// returns one past the last octet written
+//
+auto encode_huffman(span<u8 const> str, span<u8> out) -> u8*;
+
+// one of the string literals handed to `decode_huffman_batch`, along with where its decoded form goes and the outcome
+//
+struct huffman_batch_item {
+  span<u8 const>            encoded;
+  span<u8>                  out;
+  huffman_validation        validation  = huffman_validation::none;
+  usize                     num_written = 0;
+  boost::system::error_code ec;
+};
+
+// decodes every item as if by `decode_huffman`, up to 4 of them at a time
+//
+// a single Huffman-coded string is one long dependency chain through the bit accumulator, so the items' chains are
+// interleaved in the same loop for the CPU to overlap, each lane being refilled with the next item as soon as it runs
+// dry
+//
+// the output of successfully decoded items is identical to `decode_huffman`'s, while that of a failed item is only
+// good for its `ec`
+//
+auto decode_huffman_batch(span<huffman_batch_item> items) -> void;
+
+namespace detail {
+
+auto huffman_encoded_size_scalar(span<u8 const> str) -> usize;
+
+#if POTOK_HAS_SSSE3
+auto huffman_encoded_size_ssse3(span<u8 const> str) -> usize;
+#endif
+
+#if POTOK_HAS_AVX2
+auto huffman_encoded_size_avx2(span<u8 const> str) -> usize;
+#endif
+
+}    // namespace detail
+
+}    // namespace hpack
+}    // namespace potok
+
+#endif    // POTOK_HPACK_HUFFMAN_HPP_
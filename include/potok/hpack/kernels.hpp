@@ -0,0 +1,52 @@
+#ifndef POTOK_HPACK_KERNELS_HPP_
+#define POTOK_HPACK_KERNELS_HPP_
+
+#include <potok/cpu.hpp>
+#include <potok/span.hpp>
+#include <potok/stdint.hpp>
+
+namespace potok {
+namespace hpack {
+
+// the hot loops that have SIMD or BMI2 variants, see `potok/cpu.hpp`
+//
+// the public functions (`decode_indexed_run` and `huffman_encoded_size`) call through `active_kernels()`, which holds
+// the best variants for the running CPU, while the integer decoders' fast path inlines the scalar continuation kernel
+// and only calls out to the BMI2 one where pext is fast, see `detail::use_pext`
+//
+struct kernels {
+  // decodes the continuation octets of a prefix integer starting at `pos`, which must be followed by at least
+  // `max_integer_octets - 1` readable octets, adding them to `v`
+  //
+  // returns the number of continuation octets or 0 if the value doesn't fit in a u64
+  //
+  // unlike the other kernels this one is never dispatched through: it only identifies the variant picked for `level`,
+  // which is what `detail::use_pext` is set from, and lets tests and benchmarks call that variant directly
+  //
+  usize (*decode_integer_continuation)(u8 const* pos, u64& v) = nullptr;
+
+  usize (*decode_indexed_run)(span<u8 const> octets, span<u8> indices) = nullptr;
+
+  usize (*huffman_encoded_size)(span<u8 const> str) = nullptr;
+};
+
+// the best variant of each kernel at or below `level`, capped at what the CPU supports so that asking for too much
+// is never fatal
+//
+auto make_kernels(cpu_level level) -> kernels;
+
+auto active_kernels() -> kernels const&;
+
+// switches every kernel to the variants for `level`, capped at what the CPU supports, so that tests and benchmarks can
+// exercise each of them on the same machine
+//
+// not thread-safe: nothing may be decoding or encoding while the kernels are swapped out
+//
+// returns the level now in use
+//
+auto force_cpu_level(cpu_level level) -> cpu_level;
+
+}    // namespace hpack
+}    // namespace potok
+
+#endif    // POTOK_HPACK_KERNELS_HPP_
@@ -0,0 +1,101 @@
+#ifndef POTOK_HPACK_REPRESENTATION_HPP_
+#define POTOK_HPACK_REPRESENTATION_HPP_
+
+#include <potok/hpack/common.hpp>
+
+#include <potok/stdint.hpp>
+
+#include <array>
+
+namespace potok {
+namespace hpack {
+
+// the header field representations from https://datatracker.ietf.org/doc/html/rfc7541#section-6 along with the bit
+// pattern of the leading octet that selects them:
+//
+//   1xxxxxxx  indexed header field                            (7-bit prefix)
+//   01xxxxxx  literal header field with incremental indexing  (6-bit prefix)
+//   001xxxxx  dynamic table size update                       (5-bit prefix)
+//   0001xxxx  literal header field never indexed              (4-bit prefix)
+//   0000xxxx  literal header field without indexing           (4-bit prefix)
+//
+enum class representation : u8 {
+  indexed,
+  incremental_indexing,
+  size_update,
+  never_indexed,
+  without_indexing
+};
+
+// everything we need to know about a field after reading its first octet
+//
+// `value` holds the prefix bits of the octet, already masked, which is the complete integer (index or table size)
+// unless `has_continuation` is set, in which case the remainder comes from an `integer_decoder` that has been told to
+// `skip_prefix()`
+//
+// for the literal representations a `value` of 0 means the name is sent as a string literal rather than an index
+//
+struct field_prefix {
+  representation kind             = representation::indexed;
+  u8             num_prefix_bits  = 0;
+  u8             value            = 0;
+  bool           has_continuation = false;
+};
+
+namespace detail {
+
+constexpr auto make_field_prefix(u8 const octet) -> field_prefix
+{
+  auto prefix = field_prefix{};
+
+  if (octet & 0x80) {
+    prefix.kind            = representation::indexed;
+    prefix.num_prefix_bits = 7;
+  }
+  else if (octet & 0x40) {
+    prefix.kind            = representation::incremental_indexing;
+    prefix.num_prefix_bits = 6;
+  }
+  else if (octet & 0x20) {
+    prefix.kind            = representation::size_update;
+    prefix.num_prefix_bits = 5;
+  }
+  else if (octet & 0x10) {
+    prefix.kind            = representation::never_indexed;
+    prefix.num_prefix_bits = 4;
+  }
+  else {
+    prefix.kind            = representation::without_indexing;
+    prefix.num_prefix_bits = 4;
+  }
+
+  auto const max_prefix_value = get_max_prefix_value(prefix.num_prefix_bits);
+
+  prefix.value            = static_cast<u8>(octet & max_prefix_value);
+  prefix.has_continuation = (prefix.value == max_prefix_value);
+
+  return prefix;
+}
+
+constexpr auto make_field_prefix_table()
+{
+  auto table = std::array<field_prefix, 256>{};
+  for (usize i = 0; i < table.size(); ++i) { table[i] = make_field_prefix(static_cast<u8>(i)); }
+  return table;
+}
+
+}    // namespace detail
+
+// the bit-test chain above, evaluated once for every possible octet at compile-time
+//
+inline constexpr auto const field_prefix_table = detail::make_field_prefix_table();
+
+constexpr auto classify_field(u8 const first_octet) -> field_prefix
+{
+  return field_prefix_table[first_octet];
+}
+
+}    // namespace hpack
+}    // namespace potok
+
+#endif    // POTOK_HPACK_REPRESENTATION_HPP_
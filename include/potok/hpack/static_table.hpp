@@ -0,0 +1,107 @@
+#ifndef POTOK_HPACK_STATIC_TABLE_HPP_
+#define POTOK_HPACK_STATIC_TABLE_HPP_
+
+#include <potok/hpack/header_field.hpp>
+
+#include <potok/stdint.hpp>
+
+#include <array>
+#include <string_view>
+
+namespace potok {
+namespace hpack {
+
+constexpr usize const static_table_size = 61;
+
+// the predefined header fields from https://datatracker.ietf.org/doc/html/rfc7541#appendix-A
+//
+// HPACK indices are 1-based, so index `i` is `static_table[i - 1]`, and the dynamic table's entries follow on from
+// index `static_table_size + 1`
+//
+inline constexpr std::array<header_field, static_table_size> const static_table = {{
+    {":authority", ""},                      // 1
+    {":method", "GET"},                      // 2
+    {":method", "POST"},                     // 3
+    {":path", "/"},                          // 4
+    {":path", "/index.html"},                // 5
+    {":scheme", "http"},                     // 6
+    {":scheme", "https"},                    // 7
+    {":status", "200"},                      // 8
+    {":status", "204"},                      // 9
+    {":status", "206"},                      // 10
+    {":status", "304"},                      // 11
+    {":status", "400"},                      // 12
+    {":status", "404"},                      // 13
+    {":status", "500"},                      // 14
+    {"accept-charset", ""},                  // 15
+    {"accept-encoding", "gzip, deflate"},    // 16
+    {"accept-language", ""},                 // 17
+    {"accept-ranges", ""},                   // 18
+    {"accept", ""},                          // 19
+    {"access-control-allow-origin", ""},     // 20
+    {"age", ""},                             // 21
+    {"allow", ""},                           // 22
+    {"authorization", ""},                   // 23
+    {"cache-control", ""},                   // 24
+    {"content-disposition", ""},             // 25
+    {"content-encoding", ""},                // 26
+    {"content-language", ""},                // 27
+    {"content-length", ""},                  // 28
+    {"content-location", ""},                // 29
+    {"content-range", ""},                   // 30
+    {"content-type", ""},                    // 31
+    {"cookie", ""},                          // 32
+    {"date", ""},                            // 33
+    {"etag", ""},                            // 34
+    {"expect", ""},                          // 35
+    {"expires", ""},                         // 36
+    {"from", ""},                            // 37
+    {"host", ""},                            // 38
+    {"if-match", ""},                        // 39
+    {"if-modified-since", ""},               // 40
+    {"if-none-match", ""},                   // 41
+    {"if-range", ""},                        // 42
+    {"if-unmodified-since", ""},             // 43
+    {"last-modified", ""},                   // 44
+    {"link", ""},                            // 45
+    {"location", ""},                        // 46
+    {"max-forwards", ""},                    // 47
+    {"proxy-authenticate", ""},              // 48
+    {"proxy-authorization", ""},             // 49
+    {"range", ""},                           // 50
+    {"referer", ""},                         // 51
+    {"refresh", ""},                         // 52
+    {"retry-after", ""},                     // 53
+    {"server", ""},                          // 54
+    {"set-cookie", ""},                      // 55
+    {"strict-transport-security", ""},       // 56
+    {"transfer-encoding", ""},               // 57
+    {"user-agent", ""},                      // 58
+    {"vary", ""},                            // 59
+    {"via", ""},                             // 60
+    {"www-authenticate", ""},                // 61
+}};
+
+// where a header field was found in the static or the dynamic table
+//
+struct table_match {
+  // the HPACK index of the entry, 0 if not even the name was found
+  //
+  usize index = 0;
+  // the entry's value matches too, rather than just its name
+  //
+  bool full = false;
+};
+
+// looks `name` and `value` up in the static table, preferring an entry that matches both over the first one that
+// matches the name
+//
+// names are found through a perfect hash computed at compile time, so a name that isn't in the table is rejected
+// without comparing any strings in all but a few cases
+//
+auto find_static(std::string_view name, std::string_view value) -> table_match;
+
+}    // namespace hpack
+}    // namespace potok
+
+#endif    // POTOK_HPACK_STATIC_TABLE_HPP_
@@ -0,0 +1 @@
+#include <potok/bit.hpp>
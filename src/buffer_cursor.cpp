@@ -0,0 +1 @@
+#include <potok/buffer_cursor.hpp>
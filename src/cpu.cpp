@@ -0,0 +1,74 @@
+#include <potok/cpu.hpp>
+
+#if POTOK_X86_DISPATCH
+#include <cpuid.h>
+#endif
+
+namespace potok {
+
+namespace {
+
+auto detect() -> cpu_level
+{
+#if POTOK_X86_DISPATCH
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("bmi2")) { return cpu_level::avx2; }
+  if (__builtin_cpu_supports("ssse3")) { return cpu_level::ssse3; }
+  if (__builtin_cpu_supports("sse2")) { return cpu_level::sse2; }
+  return cpu_level::scalar;
+#elif POTOK_HAS_AVX2
+  return cpu_level::avx2;
+#elif POTOK_HAS_SSSE3
+  return cpu_level::ssse3;
+#elif POTOK_HAS_SSE2
+  return cpu_level::sse2;
+#else
+  return cpu_level::scalar;
+#endif
+}
+
+auto detect_fast_pext() -> bool
+{
+#if POTOK_X86_DISPATCH
+  if (detect_cpu_level() < cpu_level::avx2) { return false; }
+
+  auto eax = 0u;
+  auto ebx = 0u;
+  auto ecx = 0u;
+  auto edx = 0u;
+  if (!__get_cpuid(0, &eax, &ebx, &ecx, &edx)) { return false; }
+
+  // "AuthenticAMD" and "HygonGenuine", split across ebx, edx and ecx
+  //
+  auto const amd   = ebx == 0x68747541 && edx == 0x69746e65 && ecx == 0x444d4163;
+  auto const hygon = ebx == 0x6f677948 && edx == 0x6e65476e && ecx == 0x656e6975;
+  if (!amd && !hygon) { return true; }
+
+  if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) { return false; }
+
+  auto family = (eax >> 8) & 0xf;
+  if (family == 0xf) { family += (eax >> 20) & 0xff; }
+
+  // Zen 3 is family 19h
+  //
+  return family >= 0x19;
+#else
+  return detect_cpu_level() >= cpu_level::avx2;
+#endif
+}
+
+}    // namespace
+
+auto detect_cpu_level() -> cpu_level
+{
+  static auto const level = detect();
+  return level;
+}
+
+auto has_fast_pext() -> bool
+{
+  static auto const fast = detect_fast_pext();
+  return fast;
+}
+
+}    // namespace potok
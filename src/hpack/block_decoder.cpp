@@ -0,0 +1,318 @@
+#include <potok/hpack/block_decoder.hpp>
+#include <potok/hpack/huffman_code.hpp>
+#include <potok/hpack/static_table.hpp>
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+
+namespace potok {
+namespace hpack {
+
+namespace {
+
+// the same check `huffman_decoder` makes, for raw string literals
+//
+auto validate_raw(std::string_view const str, huffman_validation const validation, boost::system::error_code& ec)
+    -> bool
+{
+  if (validation == huffman_validation::none) { return true; }
+
+  auto classes = u8{0};
+  for (auto const c : str) { classes |= huffman_char_class(static_cast<u8>(c)); }
+
+  if (validation == huffman_validation::field_name && (classes & huffman_invalid_in_name)) {
+    ec = error::invalid_field_name;
+    return false;
+  }
+
+  if (validation == huffman_validation::field_value && (classes & huffman_invalid_in_value)) {
+    ec = error::invalid_field_value;
+    return false;
+  }
+
+  return true;
+}
+
+}    // namespace
+
+auto block_decoder::finish(boost::system::error_code& ec) -> void
+{
+  ec             = {};
+  block_started_ = false;
+
+  if (state_ != state::field_start) { ec = error::incomplete_header_block; }
+}
+
+auto block_decoder::decode(span<u8 const> const      chunk,       //
+                           field_callback const       on_field,    //
+                           void* const                ctx,         //
+                           boost::system::error_code& ec) -> usize
+{
+  auto const* const first = chunk.data();
+  auto const* const end   = first + chunk.size();
+  auto const*       pos   = first;
+
+  auto const consumed = [&] { return static_cast<usize>(pos - first); };
+
+  while (pos != end) {
+    switch (state_) {
+      case state::field_start: {
+        // once the dynamic table has warmed up, most fields are a single octet referring to an index below 127, which
+        // are looked up in runs without going through the state machine
+        //
+        if (*pos & 0x80) {
+          u8 indices[64];
+
+          auto const n = decode_indexed_run(span<u8 const>(pos, static_cast<usize>(end - pos)), indices);
+          for (usize i = 0; i < n; ++i) {
+            auto field = header_field{};
+            if (!lookup(indices[i], field, ec)) {
+              pos += i + 1;
+              return consumed();
+            }
+            on_field(ctx, field);
+          }
+
+          if (n > 0) {
+            pos += n;
+            block_started_ = true;
+            break;
+          }
+        }
+
+        auto const prefix = classify_field(*pos++);
+
+        kind_ = prefix.kind;
+        if (kind_ == representation::size_update) {
+          if (block_started_) {
+            ec = error::unexpected_size_update;
+            return consumed();
+          }
+        }
+        else {
+          block_started_ = true;
+
+          // a literal whose name is a string rather than an index
+          //
+          if (kind_ != representation::indexed && prefix.value == 0) {
+            state_ = state::name_length;
+            break;
+          }
+        }
+
+        if (prefix.has_continuation) {
+          auto const max_value = (kind_ == representation::size_update) ? u64{max_table_size_}
+                                                                        : u64{static_table_size + table_.size()};
+
+          integer_.emplace(prefix.num_prefix_bits, max_value);
+          integer_->skip_prefix();
+          state_ = state::integer;
+          break;
+        }
+
+        if (!apply_integer(prefix.value, on_field, ctx, ec)) { return consumed(); }
+        break;
+      }
+
+      case state::integer: {
+        auto v = u64{0};
+        pos += (*integer_)(span<u8 const>(pos, static_cast<usize>(end - pos)), v, ec);
+        if (ec == error::needs_more) {
+          ec = {};
+          return consumed();
+        }
+
+        if (ec) {
+          if (ec == error::limit_exceeded && kind_ != representation::size_update) { ec = error::invalid_index; }
+          return consumed();
+        }
+
+        integer_.reset();
+        if (!apply_integer(v, on_field, ctx, ec)) { return consumed(); }
+        break;
+      }
+
+      case state::name_length:
+      case state::value_length: {
+        // the H bit shares the first octet with the length's prefix
+        //
+        if (!integer_) {
+          huffman_coded_ = (*pos & 0x80) != 0;
+          integer_.emplace(u8{7}, u64{max_string_size_});
+        }
+
+        auto v = u64{0};
+        pos += (*integer_)(span<u8 const>(pos, static_cast<usize>(end - pos)), v, ec);
+        if (ec == error::needs_more) {
+          ec = {};
+          return consumed();
+        }
+        if (ec) { return consumed(); }
+
+        integer_.reset();
+        string_size_ = static_cast<usize>(v);
+        string_pos_  = 0;
+        num_decoded_ = 0;
+
+        auto& buf = (state_ == state::name_length) ? name_buf_ : value_buf_;
+        if (huffman_coded_) {
+          buf.resize(huffman_max_decoded_size(string_size_));
+          huffman_.emplace(string_size_, lookup_, validation());
+        }
+
+        state_ = (state_ == state::name_length) ? state::name : state::value;
+
+        // an empty string literal is already complete, with or without anything following it in the chunk
+        //
+        [[fallthrough]];
+      }
+
+      case state::name:
+      case state::value: {
+        if (state_ == state::name) {
+          auto name = std::string_view();
+          if (!read_string(pos, end, name_buf_, name, ec)) { return consumed(); }
+
+          field_.name    = name;
+          name_in_input_ = (name.data() != name_buf_.data());
+          state_         = state::value_length;
+          break;
+        }
+
+        auto value = std::string_view();
+        if (!read_string(pos, end, value_buf_, value, ec)) { return consumed(); }
+
+        field_.value     = value;
+        field_.sensitive = (kind_ == representation::never_indexed);
+        on_field(ctx, field_);
+
+        if (kind_ == representation::incremental_indexing) { table_.insert(field_.name, field_.value); }
+
+        field_         = {};
+        name_in_input_ = false;
+        state_         = state::field_start;
+        break;
+      }
+    }
+  }
+
+  // the chunk won't outlive this call but a name decoded from it may still be waiting for its value
+  //
+  if (name_in_input_) {
+    name_buf_.assign(field_.name);
+    field_.name    = name_buf_;
+    name_in_input_ = false;
+  }
+
+  return consumed();
+}
+
+auto block_decoder::lookup(u64 const index, header_field& field, boost::system::error_code& ec) const -> bool
+{
+  if (index == 0 || index > static_table_size + table_.size()) {
+    ec = error::invalid_index;
+    return false;
+  }
+
+  field = (index <= static_table_size) ? static_table[index - 1] : table_[index - static_table_size - 1];
+  return true;
+}
+
+auto block_decoder::apply_integer(u64 const                  v,           //
+                                  field_callback const       on_field,    //
+                                  void* const                ctx,         //
+                                  boost::system::error_code& ec) -> bool
+{
+  state_ = state::field_start;
+
+  switch (kind_) {
+    case representation::size_update: {
+      if (v > max_table_size_) {
+        ec = error::limit_exceeded;
+        return false;
+      }
+
+      table_.set_max_size(static_cast<usize>(v));
+      return true;
+    }
+
+    case representation::indexed: {
+      auto field = header_field{};
+      if (!lookup(v, field, ec)) { return false; }
+
+      on_field(ctx, field);
+      return true;
+    }
+
+    case representation::incremental_indexing:
+    case representation::never_indexed:
+    case representation::without_indexing:
+    default: {
+      auto name = header_field{};
+      if (!lookup(v, name, ec)) { return false; }
+
+      field_.name = name.name;
+      state_      = state::value_length;
+      return true;
+    }
+  }
+}
+
+auto block_decoder::validation() const noexcept -> huffman_validation
+{
+  if (!validate_fields_) { return huffman_validation::none; }
+
+  auto const is_name = (state_ == state::name_length || state_ == state::name);
+  return is_name ? huffman_validation::field_name : huffman_validation::field_value;
+}
+
+auto block_decoder::read_string(u8 const*&                 pos,    //
+                                u8 const* const            end,    //
+                                std::string&               buf,    //
+                                std::string_view&          str,    //
+                                boost::system::error_code& ec) -> bool
+{
+  auto const avail = std::min(static_cast<usize>(end - pos), string_size_ - string_pos_);
+
+  if (huffman_coded_) {
+    auto const out = span<u8>(reinterpret_cast<u8*>(buf.data()), buf.size()).subspan(num_decoded_);
+
+    auto n = usize{0};
+    (*huffman_)(span<u8 const>(pos, avail), out, n, ec);
+    num_decoded_ += n;
+    string_pos_ += avail;
+    pos += avail;
+
+    if (ec == error::needs_more) {
+      ec = {};
+      return false;
+    }
+    if (ec) { return false; }
+
+    str = std::string_view(buf.data(), num_decoded_);
+    return true;
+  }
+
+  // the whole literal is right here, which is the case worth optimizing for
+  //
+  if (string_pos_ == 0 && avail == string_size_) {
+    str = std::string_view(reinterpret_cast<char const*>(pos), avail);
+    pos += avail;
+    return validate_raw(str, validation(), ec);
+  }
+
+  if (string_pos_ == 0) { buf.resize(string_size_); }
+
+  std::copy(pos, pos + avail, buf.begin() + static_cast<std::ptrdiff_t>(string_pos_));
+  string_pos_ += avail;
+  pos += avail;
+
+  if (string_pos_ < string_size_) { return false; }
+
+  str = std::string_view(buf.data(), string_size_);
+  return validate_raw(str, validation(), ec);
+}
+
+}    // namespace hpack
+}    // namespace potok
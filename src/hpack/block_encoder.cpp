@@ -0,0 +1,213 @@
+#include <potok/hpack/block_encoder.hpp>
+#include <potok/hpack/common.hpp>
+#include <potok/hpack/encode.hpp>
+#include <potok/hpack/huffman.hpp>
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <array>
+#include <string_view>
+
+namespace potok {
+namespace hpack {
+
+namespace {
+
+// names whose values are never worth indexing in a response, sorted for `std::binary_search`
+//
+constexpr std::array<std::string_view, 9> const unindexed_response_names = {
+    "age", "content-length", "content-range", "etag", "expires", "last-modified", "link", "location", "set-cookie",
+};
+
+// an entry taking up more than 3/4 of the table would evict nearly everything else for a field that likely won't repeat
+//
+auto is_too_large(header_field const& field, dynamic_table const& table) -> bool
+{
+  return entry_size(field.name, field.value) > table.max_size() / 4 * 3;
+}
+
+// a string literal, Huffman-coded whenever that makes it shorter with ties going to the raw form as in
+// `huffman_is_shorter`
+//
+struct string_plan {
+  span<u8 const> str;
+  usize          size    = 0;
+  bool           huffman = false;
+};
+
+auto plan_string(std::string_view const str) -> string_plan
+{
+  auto const octets       = span<u8 const>(reinterpret_cast<u8 const*>(str.data()), str.size());
+  auto const huffman_size = huffman_encoded_size(octets);
+
+  if (huffman_size < octets.size()) { return {octets, huffman_size, true}; }
+  return {octets, octets.size(), false};
+}
+
+auto num_string_octets(string_plan const& plan) -> usize
+{
+  return get_num_required_octets(plan.size, 7) + plan.size;
+}
+
+// writes an integer along with the bits of its leading octet that select the representation
+//
+auto write_integer(u8* const pos, u8 const flags, u64 const v, u8 const num_prefix_bits) -> u8*
+{
+  *pos = flags;
+  return encode_integer(v, num_prefix_bits, span<u8>(pos, get_num_required_octets(v, num_prefix_bits)));
+}
+
+auto write_string(u8* pos, string_plan const& plan) -> u8*
+{
+  pos = write_integer(pos, plan.huffman ? u8{0x80} : u8{0x00}, plan.size, 7);
+  if (plan.huffman) { return encode_huffman(plan.str, span<u8>(pos, plan.size)); }
+
+  return std::copy(plan.str.begin(), plan.str.end(), pos);
+}
+
+}    // namespace
+
+auto response_indexing_policy::operator()(header_field const& field, dynamic_table const& table) const -> indexing
+{
+  if (field.sensitive) { return indexing::never; }
+
+  if (field.name == "authorization" || field.name == "proxy-authorization") { return indexing::never; }
+
+  if (std::binary_search(unindexed_response_names.begin(), unindexed_response_names.end(), field.name)) {
+    return indexing::without;
+  }
+
+  if (is_too_large(field, table)) { return indexing::without; }
+  return indexing::incremental;
+}
+
+auto static_only_indexing_policy::operator()(header_field const& field, dynamic_table const&) const -> indexing
+{
+  return field.sensitive ? indexing::never : indexing::without;
+}
+
+namespace detail {
+
+auto block_encoder_base::set_max_table_size(usize const max_table_size) -> void
+{
+  smallest_max_table_size_ = size_update_pending_ ? std::min(smallest_max_table_size_, max_table_size) : max_table_size;
+  next_max_table_size_     = max_table_size;
+  size_update_pending_     = true;
+}
+
+auto block_encoder_base::finish() -> void
+{
+  BOOST_ASSERT(!has_pending());
+  block_started_ = false;
+}
+
+auto block_encoder_base::flush(span<u8> const out) -> usize
+{
+  auto const n = std::min(out.size(), pending_.size() - pending_pos_);
+  std::copy_n(pending_.begin() + static_cast<std::ptrdiff_t>(pending_pos_), n, out.begin());
+
+  pending_pos_ += n;
+  if (pending_pos_ == pending_.size()) {
+    pending_.clear();
+    pending_pos_ = 0;
+  }
+
+  return n;
+}
+
+auto block_encoder_base::start_field() -> void
+{
+  if (block_started_) { return; }
+  block_started_ = true;
+
+  if (!size_update_pending_) { return; }
+  size_update_pending_ = false;
+
+  // the smallest size set in between two blocks has to be signalled whether it evicts anything or not, and the final
+  // one after it
+  //
+  // see: https://datatracker.ietf.org/doc/html/rfc7541#section-4.2
+  //
+  num_size_updates_ = 0;
+  if (smallest_max_table_size_ < next_max_table_size_) {
+    size_updates_[num_size_updates_++] = smallest_max_table_size_;
+  }
+  size_updates_[num_size_updates_++] = next_max_table_size_;
+
+  table_.set_max_size(smallest_max_table_size_);
+  table_.set_max_size(next_max_table_size_);
+}
+
+auto block_encoder_base::encode_field(header_field const& field, indexing const how, span<u8> const out) -> usize
+{
+  BOOST_ASSERT(!has_pending());
+  BOOST_ASSERT(block_started_);
+
+  // the size updates have to come first in the block
+  //
+  auto num_octets = usize{0};
+  for (usize i = 0; i < num_size_updates_; ++i) { num_octets += get_num_required_octets(size_updates_[i], 5); }
+
+  auto const match   = find(field);
+  auto const indexed = match.full && how != indexing::never;
+
+  // adding an entry larger than the whole table would only empty it
+  //
+  auto const incremental =
+      !indexed && how == indexing::incremental && entry_size(field.name, field.value) <= table_.table().max_size();
+
+  auto flags           = u8{0x80};
+  auto num_prefix_bits = u8{7};
+  if (!indexed) {
+    flags           = incremental ? u8{0x40} : (how == indexing::never) ? u8{0x10} : u8{0x00};
+    num_prefix_bits = incremental ? u8{6} : u8{4};
+  }
+
+  auto const name  = plan_string(match.index == 0 ? field.name : std::string_view());
+  auto const value = plan_string(indexed ? std::string_view() : field.value);
+
+  num_octets += get_num_required_octets(match.index, num_prefix_bits);
+  if (!indexed) {
+    if (match.index == 0) { num_octets += num_string_octets(name); }
+    num_octets += num_string_octets(value);
+  }
+
+  // fields are written in place unless they straddle the end of `out`
+  //
+  auto const in_place = num_octets <= out.size();
+  if (!in_place) { pending_.resize(num_octets); }
+
+  auto* pos = in_place ? out.data() : pending_.data();
+  for (usize i = 0; i < num_size_updates_; ++i) { pos = write_integer(pos, 0x20, size_updates_[i], 5); }
+  num_size_updates_ = 0;
+
+  pos = write_integer(pos, flags, match.index, num_prefix_bits);
+  if (!indexed) {
+    if (match.index == 0) { pos = write_string(pos, name); }
+    pos = write_string(pos, value);
+  }
+
+  BOOST_ASSERT(pos == (in_place ? out.data() : pending_.data()) + num_octets);
+
+  if (incremental) { table_.insert(field.name, field.value); }
+
+  return in_place ? num_octets : flush(out);
+}
+
+auto block_encoder_base::find(header_field const& field) const -> table_match
+{
+  auto const match = find_static(field.name, field.value);
+  if (match.full) { return match; }
+
+  // a full match in the dynamic table beats a name-only match anywhere, static names being preferred otherwise as
+  // their indices never change
+  //
+  auto const dynamic = table_.find(field.name, field.value);
+  return (dynamic.full || match.index == 0) ? dynamic : match;
+}
+
+}    // namespace detail
+
+}    // namespace hpack
+}    // namespace potok
@@ -1 +1,153 @@
-#include <potok/hpack/decode.hpp>
\ No newline at end of file
+#include <potok/hpack/decode.hpp>
+
+#include <potok/bit.hpp>
+
+#include <boost/endian/conversion.hpp>
+
+#include <algorithm>
+
+#if POTOK_HAS_SSE2
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace potok {
+namespace hpack {
+
+namespace {
+
+constexpr auto is_indexed_octet(u8 const octet) -> bool
+{
+  return octet > 0x80 && octet < 0xff;
+}
+
+}    // namespace
+
+#if POTOK_HAS_AVX2
+
+POTOK_TARGET("bmi2")
+auto detail::decode_integer_continuation_bmi2(u8 const* const pos, u64& v) -> usize
+{
+  auto       w          = boost::endian::load_little_u64(pos);
+  auto const num_octets = mask_continuation(w);
+
+  v += _pext_u64(w, ~continuation_bits);
+  return (num_octets != 0) ? num_octets : decode_continuation_tail(pos, v);
+}
+
+#endif
+
+auto detail::decode_indexed_run_scalar(span<u8 const> const octets, span<u8> const indices) -> usize
+{
+  auto const n = std::min(octets.size(), indices.size());
+
+  auto i = usize{0};
+  for (; i < n && is_indexed_octet(octets[i]); ++i) { indices[i] = octets[i] & 0x7f; }
+  return i;
+}
+
+// the octets we're after are exactly the signed 8-bit values in (-128, -1), which is two signed comparisons per lane
+//
+// every lane is stored speculatively and only the length of the run is trusted so there's nothing to undo once a
+// non-matching octet turns up
+//
+
+#if POTOK_HAS_SSE2
+
+POTOK_TARGET("sse2")
+auto detail::decode_indexed_run_sse2(span<u8 const> const octets, span<u8> const indices) -> usize
+{
+  auto const n = std::min(octets.size(), indices.size());
+
+  auto const* const in  = octets.data();
+  auto* const       out = indices.data();
+
+  auto const lo   = _mm_set1_epi8(-128);
+  auto const hi   = _mm_set1_epi8(-1);
+  auto const mask = _mm_set1_epi8(0x7f);
+
+  auto i = usize{0};
+  for (; i + 16 <= n; i += 16) {
+    auto const x  = _mm_loadu_si128(reinterpret_cast<__m128i const*>(in + i));
+    auto const is = _mm_and_si128(_mm_cmpgt_epi8(x, lo), _mm_cmpgt_epi8(hi, x));
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_and_si128(x, mask));
+
+    auto const matches = static_cast<u32>(_mm_movemask_epi8(is));
+    if (matches != 0xffff) { return i + countr_zero(~matches); }
+  }
+
+  return i + decode_indexed_run_scalar(octets.subspan(i, n - i), indices.subspan(i, n - i));
+}
+
+#endif
+
+#if POTOK_HAS_AVX2
+
+POTOK_TARGET("avx2")
+auto detail::decode_indexed_run_avx2(span<u8 const> const octets, span<u8> const indices) -> usize
+{
+  auto const n = std::min(octets.size(), indices.size());
+
+  auto const* const in  = octets.data();
+  auto* const       out = indices.data();
+
+  auto const lo   = _mm256_set1_epi8(-128);
+  auto const hi   = _mm256_set1_epi8(-1);
+  auto const mask = _mm256_set1_epi8(0x7f);
+
+  auto i = usize{0};
+  for (; i + 32 <= n; i += 32) {
+    auto const x  = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(in + i));
+    auto const is = _mm256_and_si256(_mm256_cmpgt_epi8(x, lo), _mm256_cmpgt_epi8(hi, x));
+
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_and_si256(x, mask));
+
+    auto const matches = static_cast<u32>(_mm256_movemask_epi8(is));
+    if (matches != 0xffffffff) { return i + countr_zero(~matches); }
+  }
+
+  return i + decode_indexed_run_sse2(octets.subspan(i, n - i), indices.subspan(i, n - i));
+}
+
+#endif
+
+#if defined(__ARM_NEON)
+
+auto detail::decode_indexed_run_neon(span<u8 const> const octets, span<u8> const indices) -> usize
+{
+  auto const n = std::min(octets.size(), indices.size());
+
+  auto const* const in  = octets.data();
+  auto* const       out = indices.data();
+
+  auto const lo   = vdupq_n_u8(0x80);
+  auto const hi   = vdupq_n_u8(0xff);
+  auto const mask = vdupq_n_u8(0x7f);
+
+  auto i = usize{0};
+  for (; i + 16 <= n; i += 16) {
+    auto const x  = vld1q_u8(in + i);
+    auto const is = vandq_u8(vcgtq_u8(x, lo), vcltq_u8(x, hi));
+
+    vst1q_u8(out + i, vandq_u8(x, mask));
+
+    // narrow each 8-bit lane down to 4 bits to get a 64-bit movemask equivalent
+    //
+    auto const matches = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(is), 4)), 0);
+    if (matches != ~u64{0}) { return i + countr_zero(~matches) / 4; }
+  }
+
+  return i + decode_indexed_run_scalar(octets.subspan(i, n - i), indices.subspan(i, n - i));
+}
+
+#endif
+
+auto decode_indexed_run(span<u8 const> const octets, span<u8> const indices) -> usize
+{
+  return active_kernels().decode_indexed_run(octets, indices);
+}
+
+}    // namespace hpack
+}    // namespace potok
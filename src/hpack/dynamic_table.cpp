@@ -0,0 +1,105 @@
+#include <potok/hpack/dynamic_table.hpp>
+
+#include <potok/bit.hpp>
+
+#include <boost/assert.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+namespace potok {
+namespace hpack {
+
+dynamic_table::dynamic_table(usize const max_size)
+    : max_size_{max_size}
+{
+  reserve(max_size);
+}
+
+auto dynamic_table::set_max_size(usize const max_size) -> void
+{
+  max_size_ = max_size;
+  evict_until(max_size_);
+  reserve(max_size_);
+}
+
+auto dynamic_table::insert(std::string_view const name, std::string_view const value) -> void
+{
+  auto const size = entry_size(name, value);
+  if (size > max_size_) {
+    evict_until(0);
+    return;
+  }
+
+  evict_until(max_size_ - size);
+
+  // the evicted entries' octets are still intact at this point, and `memmove` reads all of `name` before writing any of
+  // it, so a name referring to one of them comes through unscathed
+  //
+  auto const offset = head_;
+  auto const len    = name.size() + value.size();
+
+  auto* const dst = bytes_.data() + offset;
+  if (!name.empty()) { std::memmove(dst, name.data(), name.size()); }
+  if (!value.empty()) { std::memcpy(dst + name.size(), value.data(), value.size()); }
+
+  head_ = offset + len;
+  if (head_ >= capacity_) { head_ -= capacity_; }
+
+  entries_[(first_ + size_) & entry_mask_] = {static_cast<u32>(offset), static_cast<u32>(name.size()),
+                                              static_cast<u32>(value.size())};
+  ++size_;
+  num_octets_ += size;
+}
+
+auto dynamic_table::reserve(usize const max_size) -> void
+{
+  if (max_size <= capacity_ && !entries_.empty()) { return; }
+
+  BOOST_ASSERT(max_size <= std::numeric_limits<u32>::max() / 2);
+
+  // every entry is at least `entry_overhead` octets, which bounds how many of them there can be, and its name and value
+  // are at most `max_size - entry_overhead` octets, which bounds how far it can run into the mirror region
+  //
+  auto const max_entries = std::max(usize{1}, max_size / entry_overhead);
+
+  auto bytes   = std::vector<char>(2 * max_size);
+  auto entries = std::vector<entry>(bit_ceil(max_entries));
+
+  // the live entries are laid out again from the start of the new ring, oldest first
+  //
+  auto pos = usize{0};
+  for (usize i = 0; i < size_; ++i) {
+    auto const field = (*this)[size_ - 1 - i];
+
+    entries[i] = {static_cast<u32>(pos), static_cast<u32>(field.name.size()), static_cast<u32>(field.value.size())};
+    pos = static_cast<usize>(std::copy(field.value.begin(), field.value.end(),
+                                       std::copy(field.name.begin(), field.name.end(), bytes.begin() + pos)) -
+                             bytes.begin());
+  }
+
+  bytes_      = std::move(bytes);
+  entries_    = std::move(entries);
+  capacity_   = max_size;
+  head_       = (pos == capacity_) ? 0 : pos;
+  first_      = 0;
+  entry_mask_ = entries_.size() - 1;
+}
+
+auto dynamic_table::evict_until(usize const max_size) -> void
+{
+  while (num_octets_ > max_size) {
+    auto const& e = entries_[first_];
+    num_octets_ -= e.name_size + e.value_size + entry_overhead;
+
+    first_ = (first_ + 1) & entry_mask_;
+    --size_;
+  }
+
+  if (size_ == 0) { head_ = 0; }
+}
+
+}    // namespace hpack
+}    // namespace potok
@@ -0,0 +1,201 @@
+#include <potok/hpack/encoder_table.hpp>
+#include <potok/hpack/header_field.hpp>
+
+#include <potok/bit.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+namespace potok {
+namespace hpack {
+
+namespace {
+
+// a multiply-xorshift hash taking 8 octets at a time, good enough for keys that are checked against the table on every
+// hit anyway
+//
+auto hash_bytes(std::string_view const str, u64 const seed) -> u64
+{
+  constexpr auto const k = u64{0x9e3779b97f4a7c15};
+
+  auto h = (seed ^ str.size()) * k;
+
+  auto const* pos = str.data();
+  auto        n   = str.size();
+  for (; n >= 8; pos += 8, n -= 8) {
+    auto w = u64{0};
+    std::memcpy(&w, pos, 8);
+    h = (h ^ w) * k;
+    h ^= h >> 29;
+  }
+
+  if (n > 0) {
+    auto w = u64{0};
+    std::memcpy(&w, pos, n);
+    h = (h ^ w) * k;
+  }
+
+  h ^= h >> 32;
+  h *= k;
+  return h ^ (h >> 29);
+}
+
+auto hash_name(std::string_view const name) -> u64
+{
+  return hash_bytes(name, 0);
+}
+
+auto hash_field(u64 const name_hash, std::string_view const value) -> u64
+{
+  return hash_bytes(value, name_hash);
+}
+
+}    // namespace
+
+encoder_table::encoder_table(usize const max_size)
+    : table_(max_size)
+{
+  reserve(max_size);
+}
+
+auto encoder_table::set_max_size(usize const max_size) -> void
+{
+  auto const num_before = table_.size();
+
+  table_.set_max_size(max_size);
+  remove_evicted(num_before);
+  reserve(max_size);
+}
+
+auto encoder_table::insert(std::string_view const name, std::string_view const value) -> void
+{
+  // hashed up front since the name may refer to an entry that's about to be evicted
+  //
+  auto const name_hash  = hash_name(name);
+  auto const field_hash = hash_field(name_hash, value);
+  auto const inserted   = entry_size(name, value) <= table_.max_size();
+
+  auto const num_before = table_.size();
+
+  table_.insert(name, value);
+  if (!inserted) {
+    remove_evicted(num_before);
+    return;
+  }
+
+  ++num_inserted_;
+  remove_evicted(num_before + 1);
+
+  auto const seq = num_inserted_ - 1;
+
+  hashes_[seq & (hashes_.size() - 1)] = {static_cast<u32>(name_hash), static_cast<u32>(field_hash)};
+  store(names_, static_cast<u32>(name_hash), seq);
+  store(fields_, static_cast<u32>(field_hash), seq);
+}
+
+auto encoder_table::find(std::string_view const name, std::string_view const value) const -> table_match
+{
+  auto const name_hash  = hash_name(name);
+  auto const field_hash = hash_field(name_hash, value);
+
+  // a slot holds 1 past the sequence number, which makes `num_inserted_ - slot` the entry's position in the table
+  //
+  if (auto const s = lookup(fields_, static_cast<u32>(field_hash)); s != 0) {
+    auto const i     = static_cast<usize>(num_inserted_ - s);
+    auto const entry = table_[i];
+    if (entry.name == name && entry.value == value) { return {static_table_size + 1 + i, true}; }
+  }
+
+  if (auto const s = lookup(names_, static_cast<u32>(name_hash)); s != 0) {
+    auto const i = static_cast<usize>(num_inserted_ - s);
+    if (table_[i].name == name) { return {static_table_size + 1 + i, false}; }
+  }
+
+  return {};
+}
+
+auto encoder_table::reserve(usize const max_size) -> void
+{
+  auto const max_entries = std::max(usize{1}, max_size / entry_overhead);
+  if (hashes_.size() >= max_entries) { return; }
+
+  // the indices are kept at most half full
+  //
+  hashes_.assign(bit_ceil(max_entries), {});
+  names_.assign(2 * hashes_.size(), {});
+  fields_.assign(2 * hashes_.size(), {});
+  slot_mask_ = names_.size() - 1;
+
+  // oldest first so that the most recent entry for each key ends up in the indices
+  //
+  for (usize i = table_.size(); i-- > 0;) {
+    auto const entry = table_[i];
+    auto const seq   = num_inserted_ - 1 - i;
+
+    auto const name_hash  = hash_name(entry.name);
+    auto const field_hash = hash_field(name_hash, entry.value);
+
+    hashes_[seq & (hashes_.size() - 1)] = {static_cast<u32>(name_hash), static_cast<u32>(field_hash)};
+    store(names_, static_cast<u32>(name_hash), seq);
+    store(fields_, static_cast<u32>(field_hash), seq);
+  }
+}
+
+// drops the entries evicted since the table held `num_before` entries, counting the one just inserted if any
+//
+auto encoder_table::remove_evicted(usize const num_before) -> void
+{
+  auto const first = num_inserted_ - num_before;
+  auto const last  = num_inserted_ - table_.size();
+
+  for (auto seq = first; seq < last; ++seq) {
+    auto const& h = hashes_[seq & (hashes_.size() - 1)];
+    erase(names_, h.name, seq);
+    erase(fields_, h.field, seq);
+  }
+}
+
+auto encoder_table::lookup(std::vector<slot> const& index, u32 const hash) const -> u64
+{
+  for (auto pos = hash & slot_mask_; index[pos].seq != 0; pos = (pos + 1) & slot_mask_) {
+    if (index[pos].hash == hash) { return index[pos].seq; }
+  }
+  return 0;
+}
+
+// a key that collides with a different one replaces it, as does a more recent entry for the same key
+//
+auto encoder_table::store(std::vector<slot>& index, u32 const hash, u64 const seq) -> void
+{
+  auto pos = hash & slot_mask_;
+  while (index[pos].seq != 0 && index[pos].hash != hash) { pos = (pos + 1) & slot_mask_; }
+
+  index[pos] = {seq + 1, hash};
+}
+
+auto encoder_table::erase(std::vector<slot>& index, u32 const hash, u64 const seq) -> void
+{
+  auto pos = hash & slot_mask_;
+  while (index[pos].seq != 0 && index[pos].hash != hash) { pos = (pos + 1) & slot_mask_; }
+
+  // the key may have been taken over by a more recent entry already
+  //
+  if (index[pos].seq != seq + 1) { return; }
+
+  // backward-shift deletion: every slot after the hole that could've been stored in it moves up, which keeps all probe
+  // sequences unbroken without tombstones
+  //
+  auto hole = pos;
+  for (auto j = (hole + 1) & slot_mask_; index[j].seq != 0; j = (j + 1) & slot_mask_) {
+    auto const ideal = index[j].hash & slot_mask_;
+    if (((j - ideal) & slot_mask_) >= ((j - hole) & slot_mask_)) {
+      index[hole] = index[j];
+      hole        = j;
+    }
+  }
+
+  index[hole] = {};
+}
+
+}    // namespace hpack
+}    // namespace potok
@@ -0,0 +1 @@
+#include <potok/hpack/header_field.hpp>
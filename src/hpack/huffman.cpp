@@ -0,0 +1,673 @@
+#include <potok/hpack/huffman.hpp>
+#include <potok/hpack/huffman_code.hpp>
+#include <potok/hpack/kernels.hpp>
+
+#include <potok/cpu.hpp>
+
+#include <boost/assert.hpp>
+#include <boost/endian/conversion.hpp>
+
+#include <array>
+#include <cstddef>
+
+#if POTOK_HAS_SSSE3
+#include <immintrin.h>
+#endif
+
+namespace potok {
+namespace hpack {
+
+namespace {
+
+// every table below is generated from `huffman_codes` at compile-time so it lives in read-only memory, shared between
+// processes, and costs nothing at startup
+//
+
+// the code lengths alone, 16 rows of 16 so that each row can be loaded as a single shuffle table
+//
+constexpr auto make_bit_lens() -> std::array<u8, 256>
+{
+  auto bit_lens = std::array<u8, 256>{};
+  for (usize c = 0; c < 256; ++c) { bit_lens[c] = huffman_codes[c].bit_len; }
+  return bit_lens;
+}
+
+alignas(16) constexpr std::array<u8, 256> const huffman_bit_lens = make_bit_lens();
+
+constexpr auto const eos          = huffman_eos;
+constexpr auto const max_bit_len  = huffman_max_bit_len;
+constexpr auto const primary_bits = u32{11};
+
+// the low bits of `bits` are the code length, 0 when the primary index is only the prefix of a longer code, and the top
+// two are the symbol's `huffman_char_class`
+//
+constexpr auto const bit_len_mask = u32{0x0f};
+constexpr auto const class_mask   = u32{huffman_invalid_in_name | huffman_invalid_in_value};
+
+struct primary_entry {
+  u8 sym  = 0;
+  u8 bits = 0;
+};
+
+// the code is canonical: codes of the same length are consecutive integers and every length's codes sort after the
+// shorter ones once left-aligned
+//
+// this means the length of a long code can be found by comparing the left-aligned 32-bit window against the end of each
+// length's range (`limit`), and its symbol by its distance from the first code of that length
+//
+struct decode_tables {
+  std::array<primary_entry, (1 << primary_bits)> primary = {};
+
+  std::array<u64, max_bit_len + 1> limit  = {};
+  std::array<u32, max_bit_len + 1> first  = {};
+  std::array<u16, max_bit_len + 1> offset = {};
+  std::array<u16, 257>             sorted = {};
+};
+
+constexpr auto make_decode_tables() -> decode_tables
+{
+  auto t = decode_tables{};
+
+  auto counts = std::array<u16, max_bit_len + 1>{};
+  for (auto const& c : huffman_codes) { ++counts[c.bit_len]; }
+
+  auto code = u32{0};
+  auto idx  = u16{0};
+  for (u32 len = 1; len <= max_bit_len; ++len) {
+    code          = (code + (len > 1 ? counts[len - 1] : 0)) << (len > 1 ? 1 : 0);
+    t.first[len]  = code;
+    t.offset[len] = idx;
+    t.limit[len]  = u64{code + counts[len]} << (32 - len);
+
+    for (u32 sym = 0; sym < 257; ++sym) {
+      if (huffman_codes[sym].bit_len == len) { t.sorted[idx++] = static_cast<u16>(sym); }
+    }
+  }
+
+  for (u32 sym = 0; sym < 256; ++sym) {
+    auto const& c = huffman_codes[sym];
+    if (c.bit_len > primary_bits) { continue; }
+
+    auto const shift = primary_bits - c.bit_len;
+    auto const first = c.code << shift;
+    auto const bits  = static_cast<u8>(c.bit_len | huffman_char_class(sym));
+    for (u32 i = 0; i < (u32{1} << shift); ++i) { t.primary[first + i] = {static_cast<u8>(sym), bits}; }
+  }
+
+  return t;
+}
+
+constexpr decode_tables const huffman_decode_tables = make_decode_tables();
+
+// decodes the symbol at the top of `acc`, which must hold at least `max_bit_len` valid (or zero-filled) bits
+//
+constexpr auto decode_symbol(decode_tables const& t, u64 const acc, u32& bit_len, u32& cls) -> u32
+{
+  auto const entry = t.primary[acc >> (64 - primary_bits)];
+  if ((entry.bits & bit_len_mask) != 0) {
+    bit_len = entry.bits & bit_len_mask;
+    cls     = entry.bits & class_mask;
+    return entry.sym;
+  }
+
+  auto const window = acc >> 32;
+
+  bit_len = primary_bits + 1;
+  while (window >= t.limit[bit_len]) { ++bit_len; }
+
+  auto const sym = t.sorted[t.offset[bit_len] + (static_cast<u32>(window >> (32 - bit_len)) - t.first[bit_len])];
+
+  cls = huffman_char_class(sym);
+  return sym;
+}
+
+constexpr auto const multi_bits    = u32{12};
+constexpr auto const max_multi_sym = u32{3};
+
+// every code is at least 5 bits long, so once this many bits are left undecoded the literal is still owed
+// `max_multi_sym` octets of a `huffman_max_decoded_size` buffer and storing a whole entry can't overrun it
+//
+constexpr auto const multi_min_bits = u32{5 * max_multi_sym};
+static_assert(multi_min_bits >= multi_bits);
+
+// every symbol whose code lies entirely within a `multi_bits` window, up to `max_multi_sym` of them
+//
+// `bits` packs the number of bits these symbols span (low nibble), their count (next two bits) and the union of their
+// `huffman_char_class`es (top two bits), a count of 0 means the window starts with a code longer than `multi_bits`
+//
+struct multi_entry {
+  u8 syms[max_multi_sym] = {};
+  u8 bits                = 0;
+};
+
+constexpr auto make_multi_table() -> std::array<multi_entry, (1 << multi_bits)>
+{
+  auto const& t = huffman_decode_tables;
+
+  auto table = std::array<multi_entry, (1 << multi_bits)>{};
+  for (u32 w = 0; w < table.size(); ++w) {
+    auto& entry = table[w];
+
+    auto used    = u32{0};
+    auto count   = u32{0};
+    auto classes = u32{0};
+    for (; count < max_multi_sym && used < multi_bits; ++count) {
+      auto const acc = u64{w} << (64 - multi_bits + used);
+
+      auto       bit_len = u32{0};
+      auto       cls     = u32{0};
+      auto const sym     = decode_symbol(t, acc, bit_len, cls);
+      if (used + bit_len > multi_bits) { break; }
+
+      entry.syms[count] = static_cast<u8>(sym);
+      used += bit_len;
+      classes |= cls;
+    }
+
+    entry.bits = static_cast<u8>(used | (count << 4) | classes);
+  }
+
+  return table;
+}
+
+constexpr std::array<multi_entry, (1 << multi_bits)> const huffman_multi_table = make_multi_table();
+
+// "a0" is 00011 00000 and the 2 bits after it can only start a longer code
+//
+static_assert(huffman_multi_table[0b00011'00000'00].bits == (2 << 4 | 10));
+static_assert(huffman_multi_table[0b100001'100001].bits == (2 << 4 | 12 | huffman_invalid_in_name));
+static_assert(huffman_multi_table[0b00011'00000'00].syms[0] == 'a');
+static_assert(huffman_multi_table[0b00011'00000'00].syms[1] == '0');
+
+}    // namespace
+
+auto huffman_decoder::decode(span<u8 const> const      encoded,    //
+                             span<u8> const             out,        //
+                             boost::system::error_code& ec) -> usize
+{
+  auto const& t     = huffman_decode_tables;
+  auto const* multi = (lookup_ == huffman_lookup::multi_symbol) ? huffman_multi_table.data() : nullptr;
+
+  remaining_ -= encoded.size();
+  auto const last = (remaining_ == 0);
+
+  auto const* pos       = encoded.data();
+  auto const* const end = pos + encoded.size();
+
+  auto* const first = out.data();
+  auto*       dst   = first;
+
+  // the next undecoded bits, most significant first, with everything below the first `num_bits` cleared
+  //
+  auto acc      = acc_;
+  auto num_bits = num_bits_;
+
+  // the union of the character classes of everything decoded, so that validation costs one OR per table probe rather
+  // than a second pass over the output
+  //
+  auto classes = classes_;
+
+  auto const refill = [&] {
+    for (; num_bits <= 56 && pos != end; num_bits += 8) { acc |= u64{*pos++} << (56 - num_bits); }
+  };
+
+  for (;;) {
+    refill();
+
+    // all of the symbols are stored unconditionally and `dst` only advances by the real count, which stays within `out`
+    // for as long as there are `multi_min_bits` left
+    //
+    if (multi) {
+      while (num_bits >= multi_min_bits) {
+        auto const& entry = multi[acc >> (64 - multi_bits)];
+
+        auto const count = (u32{entry.bits} >> 4) & 0x03;
+        if (count == 0) { break; }
+
+        auto const bit_len = u32{entry.bits} & 0x0f;
+
+        dst[0] = entry.syms[0];
+        dst[1] = entry.syms[1];
+        dst[2] = entry.syms[2];
+        dst += count;
+        classes |= entry.bits;
+
+        acc <<= bit_len;
+        num_bits -= bit_len;
+      }
+
+      refill();
+    }
+
+    // a primary hit whose code is already complete is the common case and needs no other checks: EOS is 30 bits long
+    // and the padding can't be mistaken for a code that fits
+    //
+    // the bits past `num_bits` are zero so the index is only ever completed by a code that's entirely within them
+    //
+    auto const entry   = t.primary[acc >> (64 - primary_bits)];
+    auto const bit_len = u32{entry.bits} & bit_len_mask;
+    if (bit_len - 1 < num_bits) {
+      *dst++ = entry.sym;
+      classes |= entry.bits;
+
+      acc <<= bit_len;
+      num_bits -= bit_len;
+      continue;
+    }
+
+    // everything else ends up here: long codes, EOS and the end of the input
+    //
+    // with more of the literal still to come, a short accumulator may hold the start of a code that's only completed by
+    // the next piece
+    //
+    if (!last && num_bits < max_bit_len) { break; }
+
+    auto       long_len = u32{0};
+    auto       cls      = u32{0};
+    auto const sym      = decode_symbol(t, acc, long_len, cls);
+
+    // the accumulator only ever runs low once the input is exhausted, so a code that doesn't fit marks the padding
+    //
+    if (long_len > num_bits) { break; }
+
+    if (sym == eos) {
+      ec    = error::huffman_eos;
+      done_ = true;
+      return static_cast<usize>(dst - first);
+    }
+
+    *dst++ = static_cast<u8>(sym);
+    classes |= cls;
+
+    acc <<= long_len;
+    num_bits -= long_len;
+  }
+
+  BOOST_ASSERT(pos == end);
+
+  acc_      = acc;
+  num_bits_ = num_bits;
+  classes_  = classes;
+
+  if (validation_ == huffman_validation::field_name && (classes & huffman_invalid_in_name)) {
+    ec    = error::invalid_field_name;
+    done_ = true;
+    return static_cast<usize>(dst - first);
+  }
+
+  if (validation_ == huffman_validation::field_value && (classes & huffman_invalid_in_value)) {
+    ec    = error::invalid_field_value;
+    done_ = true;
+    return static_cast<usize>(dst - first);
+  }
+
+  if (last) {
+    done_ = true;
+
+    // whatever is left over is the padding, which must be the most significant bits of EOS, i.e. all ones, and
+    // shorter than an octet
+    //
+    auto const ones = (num_bits == 0) ? u64{0} : (~u64{0} << (64 - num_bits));
+    if (acc != ones) {
+      ec = error::huffman_invalid_padding;
+    }
+    else if (num_bits > 7) {
+      ec = error::huffman_padding_too_long;
+    }
+  }
+
+  return static_cast<usize>(dst - first);
+}
+
+auto decode_huffman(span<u8 const> const       encoded,    //
+                    span<u8> const             out,        //
+                    boost::system::error_code& ec,         //
+                    huffman_lookup const       lookup,     //
+                    huffman_validation const   validation) -> usize
+{
+  BOOST_ASSERT(out.size() >= huffman_max_decoded_size(encoded.size()));
+
+  auto d           = huffman_decoder(encoded.size(), lookup, validation);
+  auto num_written = usize{0};
+
+  d(encoded, out, num_written, ec);
+  return num_written;
+}
+
+auto decode_huffman(span<u8 const> const       encoded,    //
+                    std::pmr::memory_resource* mr,         //
+                    boost::system::error_code& ec,         //
+                    huffman_lookup const       lookup,     //
+                    huffman_validation const   validation) -> std::pmr::string
+{
+  BOOST_ASSERT(mr);
+
+  auto str = std::pmr::string(huffman_max_decoded_size(encoded.size()), '\0', mr);
+
+  auto const num_written =
+    decode_huffman(encoded, span<u8>(reinterpret_cast<u8*>(str.data()), str.size()), ec, lookup, validation);
+
+  // shrinking never reallocates
+  //
+  str.resize(num_written);
+  return str;
+}
+
+auto detail::huffman_encoded_size_scalar(span<u8 const> const str) -> usize
+{
+  auto num_bits = usize{0};
+  for (auto const c : str) { num_bits += huffman_bit_lens[c]; }
+
+  return (num_bits + 7) / 8;
+}
+
+namespace {
+
+// the state of one of the strings `decode_huffman_batch` decodes side by side
+//
+struct batch_lane {
+  huffman_batch_item* item     = nullptr;
+  u8 const*           pos      = nullptr;
+  u8 const*           end      = nullptr;
+  u8*                 dst      = nullptr;
+  u64                 acc      = 0;
+  u32                 num_bits = 0;
+  u32                 classes  = 0;
+  bool                eos      = false;
+};
+
+constexpr auto const max_batch_lanes = usize{4};
+
+// anything shorter is over before interleaving could pay for the lane setup and the hand-off to `huffman_decoder`
+//
+constexpr auto const min_batch_size = std::ptrdiff_t{32};
+
+// a lane needs a whole 64-bit load's worth of input to be refilled without bounds checks
+//
+auto can_interleave(batch_lane const& lane) -> bool
+{
+  return lane.end - lane.pos >= 8;
+}
+
+auto start_lane(huffman_batch_item& item) -> batch_lane
+{
+  BOOST_ASSERT(item.out.size() >= huffman_max_decoded_size(item.encoded.size()));
+
+  auto lane = batch_lane{};
+  lane.item = &item;
+  lane.pos  = item.encoded.data();
+  lane.end  = lane.pos + item.encoded.size();
+  lane.dst  = item.out.data();
+  return lane;
+}
+
+// hands whatever the lane hasn't decoded yet over to a regular `huffman_decoder`, which also validates the padding
+//
+auto finish_lane(batch_lane const& lane) -> void
+{
+  auto& item = *lane.item;
+
+  auto const num_written = static_cast<usize>(lane.dst - item.out.data());
+  if (lane.eos) {
+    item.num_written = num_written;
+    item.ec          = error::huffman_eos;
+    return;
+  }
+
+  auto const rest = span<u8 const>(lane.pos, static_cast<usize>(lane.end - lane.pos));
+
+  auto d = huffman_decoder(rest.size(), huffman_lookup::single_symbol, item.validation);
+
+  // the refill below loads bits past `num_bits`, which the decoder expects to be cleared
+  //
+  d.acc_      = (lane.num_bits == 0) ? u64{0} : (lane.acc & (~u64{0} << (64 - lane.num_bits)));
+  d.num_bits_ = lane.num_bits;
+  d.classes_  = lane.classes;
+
+  auto n = usize{0};
+  d(rest, item.out.subspan(num_written), n, item.ec);
+  item.num_written = num_written + n;
+}
+
+// decodes 2 symbols from each of the `N` lanes per round for as long as they all have the input for it
+//
+// the lanes are worked on in local copies with a fixed count so that their state can stay in registers: the stores
+// through `dst` could otherwise alias any of it
+//
+template <usize N>
+auto interleave(batch_lane* const lanes) -> void
+{
+  auto const& t = huffman_decode_tables;
+
+  batch_lane l[N];
+  for (usize i = 0; i < N; ++i) { l[i] = lanes[i]; }
+
+  for (;;) {
+    auto ready = true;
+    for (usize i = 0; i < N; ++i) { ready &= can_interleave(l[i]); }
+    if (!ready) { break; }
+
+    for (usize i = 0; i < N; ++i) {
+      auto& lane = l[i];
+
+      // branchless refill: top up to at least 56 bits, re-loading the partial octet that didn't fit last time
+      //
+      lane.acc |= boost::endian::load_big_u64(lane.pos) >> lane.num_bits;
+      lane.pos += (63 - lane.num_bits) >> 3;
+      lane.num_bits |= 56;
+
+      // the first symbol always fits, the second only when the first left enough bits for it, which is made a
+      // conditional advance rather than a branch
+      //
+      for (u32 j = 0; j < 2; ++j) {
+        auto       bit_len = u32{0};
+        auto       cls     = u32{0};
+        auto const sym     = decode_symbol(t, lane.acc, bit_len, cls);
+
+        auto const fits = bit_len <= lane.num_bits;
+        auto const used = fits ? bit_len : 0;
+
+        *lane.dst = static_cast<u8>(sym);
+        lane.dst += fits;
+        lane.eos |= fits && sym == eos;
+        lane.classes |= fits ? cls : 0;
+
+        lane.acc <<= used;
+        lane.num_bits -= used;
+      }
+    }
+  }
+
+  for (usize i = 0; i < N; ++i) { lanes[i] = l[i]; }
+}
+
+}    // namespace
+
+auto decode_huffman_batch(span<huffman_batch_item> const items) -> void
+{
+  batch_lane lanes[max_batch_lanes] = {};
+
+  auto num_lanes = usize{0};
+  auto next      = usize{0};
+
+  // assigns the next item long enough to be worth interleaving to `lane`, finishing the short ones along the way
+  //
+  auto const assign = [&](batch_lane& lane) -> bool {
+    while (next < items.size()) {
+      lane = start_lane(items[next++]);
+      if (lane.end - lane.pos >= min_batch_size) { return true; }
+      finish_lane(lane);
+    }
+    return false;
+  };
+
+  while (num_lanes < max_batch_lanes && assign(lanes[num_lanes])) { ++num_lanes; }
+
+  while (num_lanes > 0) {
+    switch (num_lanes) {
+      case 4: interleave<4>(lanes); break;
+      case 3: interleave<3>(lanes); break;
+      case 2: interleave<2>(lanes); break;
+      default: interleave<1>(lanes); break;
+    }
+
+    for (usize i = 0; i < num_lanes;) {
+      if (can_interleave(lanes[i]) && !lanes[i].eos) {
+        ++i;
+        continue;
+      }
+
+      finish_lane(lanes[i]);
+      if (!assign(lanes[i])) { lanes[i] = lanes[--num_lanes]; }
+    }
+  }
+}
+
+// the length table is split into 16 rows by the high nibble of the octet: each row is a 16-entry shuffle table indexed
+// by the low nibble, and a lane only keeps the lookup from the row matching its own high nibble
+//
+// a shuffle zeroes lanes whose index has its top bit set, so the rows for the upper half are looked up with that bit
+// flipped, and only when the block has any such octets at all; header values are nearly always ASCII
+//
+// every length fits in an octet so the lanes are summed with psadbw against zero
+//
+
+#if POTOK_HAS_SSSE3
+
+POTOK_TARGET("ssse3")
+auto detail::huffman_encoded_size_ssse3(span<u8 const> const str) -> usize
+{
+  auto const* const in = str.data();
+  auto const        n  = str.size();
+
+  auto const* const rows = reinterpret_cast<__m128i const*>(huffman_bit_lens.data());
+
+  auto const nibble = _mm_set1_epi8(0x0f);
+  auto const top    = _mm_set1_epi8(-128);
+  auto const zero   = _mm_setzero_si128();
+
+  auto i    = usize{0};
+  auto sums = _mm_setzero_si128();
+  for (; i + 16 <= n; i += 16) {
+    auto const x  = _mm_loadu_si128(reinterpret_cast<__m128i const*>(in + i));
+    auto const hi = _mm_and_si128(_mm_srli_epi16(x, 4), nibble);
+
+    auto lens = _mm_setzero_si128();
+    for (u32 h = 0; h < 8; ++h) {
+      auto const in_row = _mm_cmpeq_epi8(hi, _mm_set1_epi8(static_cast<char>(h)));
+      lens              = _mm_or_si128(lens, _mm_and_si128(in_row, _mm_shuffle_epi8(_mm_load_si128(rows + h), x)));
+    }
+
+    if (_mm_movemask_epi8(x) != 0) {
+      auto const y = _mm_xor_si128(x, top);
+      for (u32 h = 8; h < 16; ++h) {
+        auto const in_row = _mm_cmpeq_epi8(hi, _mm_set1_epi8(static_cast<char>(h)));
+        lens              = _mm_or_si128(lens, _mm_and_si128(in_row, _mm_shuffle_epi8(_mm_load_si128(rows + h), y)));
+      }
+    }
+
+    sums = _mm_add_epi64(sums, _mm_sad_epu8(lens, zero));
+  }
+
+  auto num_bits = static_cast<usize>(_mm_cvtsi128_si64(_mm_add_epi64(sums, _mm_unpackhi_epi64(sums, sums))));
+  for (; i < n; ++i) { num_bits += huffman_bit_lens[in[i]]; }
+
+  return (num_bits + 7) / 8;
+}
+
+#endif
+
+#if POTOK_HAS_AVX2
+
+POTOK_TARGET("avx2")
+auto detail::huffman_encoded_size_avx2(span<u8 const> const str) -> usize
+{
+  auto const* const in = str.data();
+  auto const        n  = str.size();
+
+  auto const* const rows = reinterpret_cast<__m128i const*>(huffman_bit_lens.data());
+
+  auto const nibble = _mm256_set1_epi8(0x0f);
+  auto const top    = _mm256_set1_epi8(-128);
+  auto const zero   = _mm256_setzero_si256();
+
+  auto i    = usize{0};
+  auto sums = _mm256_setzero_si256();
+  for (; i + 32 <= n; i += 32) {
+    auto const x  = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(in + i));
+    auto const hi = _mm256_and_si256(_mm256_srli_epi16(x, 4), nibble);
+
+    auto lens = _mm256_setzero_si256();
+    for (u32 h = 0; h < 8; ++h) {
+      auto const row    = _mm256_broadcastsi128_si256(_mm_load_si128(rows + h));
+      auto const in_row = _mm256_cmpeq_epi8(hi, _mm256_set1_epi8(static_cast<char>(h)));
+      lens              = _mm256_or_si256(lens, _mm256_and_si256(in_row, _mm256_shuffle_epi8(row, x)));
+    }
+
+    if (_mm256_movemask_epi8(x) != 0) {
+      auto const y = _mm256_xor_si256(x, top);
+      for (u32 h = 8; h < 16; ++h) {
+        auto const row    = _mm256_broadcastsi128_si256(_mm_load_si128(rows + h));
+        auto const in_row = _mm256_cmpeq_epi8(hi, _mm256_set1_epi8(static_cast<char>(h)));
+        lens              = _mm256_or_si256(lens, _mm256_and_si256(in_row, _mm256_shuffle_epi8(row, y)));
+      }
+    }
+
+    sums = _mm256_add_epi64(sums, _mm256_sad_epu8(lens, zero));
+  }
+
+  auto const s = _mm_add_epi64(_mm256_castsi256_si128(sums), _mm256_extracti128_si256(sums, 1));
+
+  auto num_bits = static_cast<usize>(_mm_cvtsi128_si64(_mm_add_epi64(s, _mm_unpackhi_epi64(s, s))));
+  for (; i < n; ++i) { num_bits += huffman_bit_lens[in[i]]; }
+
+  return (num_bits + 7) / 8;
+}
+
+#endif
+
+auto huffman_encoded_size(span<u8 const> const str) -> usize
+{
+  return active_kernels().huffman_encoded_size(str);
+}
+
+auto huffman_is_shorter(span<u8 const> const str) -> bool
+{
+  return huffman_encoded_size(str) < str.size();
+}
+
+auto encode_huffman(span<u8 const> const str, span<u8> const out) -> u8*
+{
+  BOOST_ASSERT(out.size() >= huffman_encoded_size(str));
+
+  auto* pos = out.data();
+
+  // codes are appended to the least significant end, only the lowest `num_bits` bits being pending output
+  //
+  // no code is longer than 30 bits so the accumulator can always take one more while it holds fewer than 32, and every
+  // time it reaches 32 they're flushed as a single big-endian store
+  //
+  auto acc      = u64{0};
+  auto num_bits = u32{0};
+  for (auto const c : str) {
+    auto const& code = huffman_codes[c];
+
+    acc      = (acc << code.bit_len) | code.code;
+    num_bits = num_bits + code.bit_len;
+
+    if (num_bits >= 32) {
+      num_bits -= 32;
+      boost::endian::store_big_u32(pos, static_cast<u32>(acc >> num_bits));
+      pos += 4;
+    }
+  }
+
+  for (; num_bits >= 8; num_bits -= 8) { *pos++ = static_cast<u8>(acc >> (num_bits - 8)); }
+
+  if (num_bits > 0) { *pos++ = static_cast<u8>((acc << (8 - num_bits)) | (0xff >> num_bits)); }
+
+  return pos;
+}
+
+}    // namespace hpack
+}    // namespace potok
@@ -0,0 +1 @@
+#include <potok/hpack/huffman_code.hpp>
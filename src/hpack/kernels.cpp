@@ -0,0 +1,90 @@
+#include <potok/hpack/kernels.hpp>
+
+#include <potok/hpack/decode.hpp>
+#include <potok/hpack/huffman.hpp>
+
+#include <algorithm>
+
+namespace potok {
+namespace hpack {
+
+namespace {
+
+auto active() -> kernels&
+{
+  static auto k = make_kernels(detect_cpu_level());
+  return k;
+}
+
+#if POTOK_HAS_AVX2
+
+auto uses_pext(kernels const& k) -> bool
+{
+  return k.decode_integer_continuation == &detail::decode_integer_continuation_bmi2;
+}
+
+#endif
+
+}    // namespace
+
+#if POTOK_HAS_AVX2
+
+// anything decoded before this is initialized falls back to the scalar code, which is always correct
+//
+bool detail::use_pext = uses_pext(make_kernels(detect_cpu_level()));
+
+#endif
+
+auto make_kernels(cpu_level level) -> kernels
+{
+  level = std::min(level, detect_cpu_level());
+
+  auto k = kernels{};
+
+  k.decode_integer_continuation = &detail::decode_integer_continuation_scalar;
+  k.decode_indexed_run          = &detail::decode_indexed_run_scalar;
+  k.huffman_encoded_size        = &detail::huffman_encoded_size_scalar;
+
+#if defined(__ARM_NEON)
+  k.decode_indexed_run = &detail::decode_indexed_run_neon;
+#endif
+
+#if POTOK_HAS_SSE2
+  if (level >= cpu_level::sse2) { k.decode_indexed_run = &detail::decode_indexed_run_sse2; }
+#endif
+
+#if POTOK_HAS_SSSE3
+  if (level >= cpu_level::ssse3) { k.huffman_encoded_size = &detail::huffman_encoded_size_ssse3; }
+#endif
+
+#if POTOK_HAS_AVX2
+  if (level >= cpu_level::avx2) {
+    k.decode_indexed_run   = &detail::decode_indexed_run_avx2;
+    k.huffman_encoded_size = &detail::huffman_encoded_size_avx2;
+
+    // a microcoded pext is far slower than the scalar code
+    //
+    if (has_fast_pext()) { k.decode_integer_continuation = &detail::decode_integer_continuation_bmi2; }
+  }
+#endif
+
+  static_cast<void>(level);
+  return k;
+}
+
+auto active_kernels() -> kernels const&
+{
+  return active();
+}
+
+auto force_cpu_level(cpu_level const level) -> cpu_level
+{
+  active() = make_kernels(level);
+#if POTOK_HAS_AVX2
+  detail::use_pext = uses_pext(active());
+#endif
+  return std::min(level, detect_cpu_level());
+}
+
+}    // namespace hpack
+}    // namespace potok
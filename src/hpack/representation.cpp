@@ -0,0 +1 @@
+#include <potok/hpack/representation.hpp>
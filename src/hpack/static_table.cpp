@@ -0,0 +1,104 @@
+#include <potok/hpack/static_table.hpp>
+
+#include <algorithm>
+#include <array>
+
+namespace potok {
+namespace hpack {
+
+namespace {
+
+// the static table's names all differ in their length or in their first, middle or last character, so those are all
+// that a name is keyed on
+//
+constexpr auto name_key(std::string_view const name) noexcept -> u32
+{
+  auto const n = name.size();
+  return static_cast<u32>(n & 0xff) | (static_cast<u32>(static_cast<u8>(name[0])) << 8) |
+         (static_cast<u32>(static_cast<u8>(name[n / 2])) << 16) |
+         (static_cast<u32>(static_cast<u8>(name[n - 1])) << 24);
+}
+
+constexpr usize const num_name_slots = 256;
+
+constexpr auto slot_of(u32 const seed, u32 const key) noexcept -> usize
+{
+  return static_cast<usize>(static_cast<u32>(key * seed) >> 24);
+}
+
+// the entries of the static table sharing a name, which are always adjacent
+//
+struct name_slot {
+  u32 key   = 0;
+  u8  index = 0;
+  u8  count = 0;
+};
+
+struct name_index {
+  u32                                   seed          = 0;
+  usize                                 max_name_size = 0;
+  std::array<name_slot, num_name_slots> slots         = {};
+};
+
+// tries multipliers until one sends every name to a slot of its own, which makes the lookup a perfect hash
+//
+// a name repeated further down the table, or 2 names sharing a key, would collide with themselves for every multiplier
+// and fail the `static_assert` below
+//
+constexpr auto make_name_index() noexcept -> name_index
+{
+  auto seed = u32{0x9e3779b9};
+  for (usize attempt = 0; attempt < 100000; ++attempt) {
+    seed = (seed * 0x2c9277b5 + 0xac564b05) | 1;
+
+    auto index = name_index{seed, 0, {}};
+    auto ok    = true;
+    for (usize i = 0; ok && i < static_table_size;) {
+      auto const name  = static_table[i].name;
+      auto       count = usize{1};
+      while (i + count < static_table_size && static_table[i + count].name == name) { ++count; }
+
+      auto& slot = index.slots[slot_of(seed, name_key(name))];
+      if (slot.index != 0) {
+        ok = false;
+      }
+      else {
+        slot                = {name_key(name), static_cast<u8>(i + 1), static_cast<u8>(count)};
+        index.max_name_size = std::max(index.max_name_size, name.size());
+      }
+
+      i += count;
+    }
+
+    if (ok) { return index; }
+  }
+
+  return {};
+}
+
+static_assert(static_table_size < 256, "static table indices have to fit in a u8");
+
+constexpr name_index const static_names = make_name_index();
+static_assert(static_names.seed != 0, "no multiplier hashes the static table's names without collisions");
+
+}    // namespace
+
+auto find_static(std::string_view const name, std::string_view const value) -> table_match
+{
+  if (name.empty() || name.size() > static_names.max_name_size) { return {}; }
+
+  // an empty slot has a key of 0, which no non-empty name has, so a miss is almost always settled by the key alone
+  //
+  auto const  key  = name_key(name);
+  auto const& slot = static_names.slots[slot_of(static_names.seed, key)];
+  if (slot.key != key || static_table[slot.index - 1].name != name) { return {}; }
+
+  for (usize i = slot.index; i < usize{slot.index} + slot.count; ++i) {
+    if (static_table[i - 1].value == value) { return {i, true}; }
+  }
+
+  return {slot.index, false};
+}
+
+}    // namespace hpack
+}    // namespace potok
@@ -0,0 +1,93 @@
+#define CATCH_CONFIG_MAIN
+#include "catch_amalgamated.hpp"
+
+#include <potok/buffer_cursor.hpp>
+#include <potok/stdint.hpp>
+
+#include <boost/asio/buffer.hpp>
+
+#include <array>
+#include <type_traits>
+#include <vector>
+
+using namespace potok::ints;
+
+TEST_CASE("A cursor over a single buffer should expose it as one chunk")
+{
+  auto storage = std::vector<u8>{1, 2, 3, 4};
+  auto buf     = boost::asio::const_buffer(storage.data(), storage.size());
+
+  auto cursor = potok::buffer_cursor(buf);
+  static_assert(std::is_same_v<decltype(cursor)::value_type, u8 const>);
+
+  REQUIRE(!cursor.empty());
+  REQUIRE(cursor.chunk().data() == storage.data());
+  REQUIRE(cursor.chunk().size() == 4);
+
+  cursor.advance(3);
+  REQUIRE(cursor.chunk().size() == 1);
+  REQUIRE(cursor.chunk()[0] == 4);
+  REQUIRE(cursor.consumed() == 3);
+
+  cursor.advance(1);
+  REQUIRE(cursor.empty());
+  REQUIRE(cursor.consumed() == 4);
+}
+
+TEST_CASE("A cursor should walk a buffer sequence segment by segment, skipping empty ones")
+{
+  auto storage = std::vector<u8>{1, 2, 3, 4, 5, 6};
+
+  auto const buf_seq = std::array<boost::asio::const_buffer, 5>{
+      boost::asio::const_buffer(storage.data(), 0),     boost::asio::const_buffer(storage.data(), 2),
+      boost::asio::const_buffer(storage.data() + 2, 0), boost::asio::const_buffer(storage.data() + 2, 3),
+      boost::asio::const_buffer(storage.data() + 5, 1),
+  };
+
+  auto cursor = potok::buffer_cursor(buf_seq);
+
+  auto visited = std::vector<u8>();
+  auto chunks  = 0;
+  while (!cursor.empty()) {
+    auto const chunk = cursor.chunk();
+    visited.insert(visited.end(), chunk.begin(), chunk.end());
+    cursor.advance(chunk.size());
+    ++chunks;
+  }
+
+  REQUIRE(chunks == 3);
+  REQUIRE(visited == storage);
+  REQUIRE(cursor.consumed() == storage.size());
+}
+
+TEST_CASE("A cursor over a MutableBufferSequence should hand out writable chunks")
+{
+  auto storage = std::vector<u8>(4);
+
+  auto const buf_seq = std::array<boost::asio::mutable_buffer, 2>{
+      boost::asio::mutable_buffer(storage.data(), 1),
+      boost::asio::mutable_buffer(storage.data() + 1, 3),
+  };
+
+  auto cursor = potok::buffer_cursor(buf_seq);
+  static_assert(std::is_same_v<decltype(cursor)::value_type, u8>);
+
+  auto x = u8{1};
+  while (!cursor.empty()) {
+    auto const chunk = cursor.chunk();
+    for (auto& octet : chunk) { octet = x++; }
+    cursor.advance(chunk.size());
+  }
+
+  REQUIRE(storage == std::vector<u8>{1, 2, 3, 4});
+}
+
+TEST_CASE("An empty buffer sequence should yield an empty cursor")
+{
+  auto const buf_seq = std::array<boost::asio::const_buffer, 0>{};
+
+  auto cursor = potok::buffer_cursor(buf_seq);
+  REQUIRE(cursor.empty());
+  REQUIRE(cursor.chunk().empty());
+  REQUIRE(cursor.consumed() == 0);
+}
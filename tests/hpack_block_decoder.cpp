@@ -0,0 +1,493 @@
+#define CATCH_CONFIG_MAIN
+#include "catch_amalgamated.hpp"
+
+#include <potok/hpack/block_decoder.hpp>
+#include <potok/hpack/error.hpp>
+#include <potok/hpack/header_field.hpp>
+
+#include <potok/span.hpp>
+#include <potok/stdint.hpp>
+
+#include <boost/asio/buffer.hpp>
+
+#include <algorithm>
+#include <array>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace potok::ints;
+
+namespace {
+
+using fields = std::vector<std::pair<std::string, std::string>>;
+
+// feeds `block` to `d` `chunk_size` octets at a time, each piece in a call of its own as if it came in its own frame
+//
+auto decode_block(potok::hpack::block_decoder& d,             //
+                  std::vector<u8> const&       block,         //
+                  usize const                  chunk_size,    //
+                  boost::system::error_code&   ec) -> fields
+{
+  auto out = fields();
+
+  auto const on_field = [&](potok::hpack::header_field const& field) {
+    out.emplace_back(std::string(field.name), std::string(field.value));
+  };
+
+  for (usize pos = 0; pos < block.size();) {
+    auto const n     = std::min(chunk_size, block.size() - pos);
+    auto const chunk = potok::span<u8 const>(block.data() + pos, n);
+
+    auto const consumed = d(chunk, on_field, ec);
+    if (ec) { return out; }
+
+    CHECK(consumed == n);
+    pos += n;
+  }
+
+  d.finish(ec);
+  return out;
+}
+
+auto table_entries(potok::hpack::dynamic_table const& table) -> fields
+{
+  auto out = fields();
+  for (usize i = 0; i < table.size(); ++i) {
+    out.emplace_back(std::string(table[i].name), std::string(table[i].value));
+  }
+  return out;
+}
+
+// a header block from RFC 7541 Appendix C along with what it decodes to and the state of the dynamic table after it
+//
+struct example {
+  std::vector<u8> block;
+  fields          expected;
+  fields          table;
+  usize           table_size = 0;
+};
+
+// decodes the examples in order on a single connection, in pieces of various sizes, with either Huffman table and with
+// and without validating the fields
+//
+auto check_examples(usize const max_table_size, std::vector<example> const& examples) -> void
+{
+  for (auto const lookup : {potok::hpack::huffman_lookup::single_symbol, potok::hpack::huffman_lookup::multi_symbol}) {
+    for (auto const validate_fields : {false, true}) {
+      for (usize const chunk_size : {usize{1}, usize{2}, usize{5}, usize{4096}}) {
+        auto d =
+            potok::hpack::block_decoder(max_table_size, potok::hpack::default_max_string_size, lookup, validate_fields);
+        for (auto const& ex : examples) {
+          auto ec = boost::system::error_code();
+          CHECK(decode_block(d, ex.block, chunk_size, ec) == ex.expected);
+          CHECK(!ec);
+          CHECK(table_entries(d.table()) == ex.table);
+          CHECK(d.table().num_octets() == ex.table_size);
+        }
+      }
+    }
+  }
+}
+
+}    // namespace
+
+TEST_CASE("C.3. Request Examples without Huffman Coding")
+{
+  // https://datatracker.ietf.org/doc/html/rfc7541#appendix-C.3
+  //
+  check_examples(4096,
+                 {
+    {{
+       0x82, 0x86, 0x84, 0x41, 0x0f, 0x77, 0x77, 0x77, 0x2e, 0x65, 0x78, 0x61, 0x6d, 0x70,
+       0x6c, 0x65, 0x2e, 0x63, 0x6f, 0x6d},
+     {{":method", "GET"}, {":scheme", "http"}, {":path", "/"}, {":authority", "www.example.com"}},
+     {{":authority", "www.example.com"}},
+     57},
+    {{
+       0x82, 0x86, 0x84, 0xbe, 0x58, 0x08, 0x6e, 0x6f, 0x2d, 0x63, 0x61, 0x63, 0x68, 0x65},
+     {{":method", "GET"},
+        {":scheme", "http"},
+        {":path", "/"},
+        {":authority", "www.example.com"},
+        {"cache-control", "no-cache"}},
+     {{"cache-control", "no-cache"}, {":authority", "www.example.com"}},
+     110},
+    {{
+       0x82, 0x87, 0x85, 0xbf, 0x40, 0x0a, 0x63, 0x75, 0x73, 0x74, 0x6f, 0x6d, 0x2d, 0x6b,
+       0x65, 0x79, 0x0c, 0x63, 0x75, 0x73, 0x74, 0x6f, 0x6d, 0x2d, 0x76, 0x61, 0x6c, 0x75,
+       0x65},
+     {{":method", "GET"},
+        {":scheme", "https"},
+        {":path", "/index.html"},
+        {":authority", "www.example.com"},
+        {"custom-key", "custom-value"}},
+     {{"custom-key", "custom-value"}, {"cache-control", "no-cache"}, {":authority", "www.example.com"}},
+     164}
+                 });
+}
+
+TEST_CASE("C.4. Request Examples with Huffman Coding")
+{
+  // https://datatracker.ietf.org/doc/html/rfc7541#appendix-C.4
+  //
+  check_examples(4096,
+                 {
+    {{
+       0x82, 0x86, 0x84, 0x41, 0x8c, 0xf1, 0xe3, 0xc2, 0xe5, 0xf2, 0x3a, 0x6b, 0xa0, 0xab,
+       0x90, 0xf4, 0xff},
+     {{":method", "GET"}, {":scheme", "http"}, {":path", "/"}, {":authority", "www.example.com"}},
+     {{":authority", "www.example.com"}},
+     57},
+    {{
+       0x82, 0x86, 0x84, 0xbe, 0x58, 0x86, 0xa8, 0xeb, 0x10, 0x64, 0x9c, 0xbf},
+     {{":method", "GET"},
+        {":scheme", "http"},
+        {":path", "/"},
+        {":authority", "www.example.com"},
+        {"cache-control", "no-cache"}},
+     {{"cache-control", "no-cache"}, {":authority", "www.example.com"}},
+     110},
+    {{
+       0x82, 0x87, 0x85, 0xbf, 0x40, 0x88, 0x25, 0xa8, 0x49, 0xe9, 0x5b, 0xa9, 0x7d, 0x7f,
+       0x89, 0x25, 0xa8, 0x49, 0xe9, 0x5b, 0xb8, 0xe8, 0xb4, 0xbf},
+     {{":method", "GET"},
+        {":scheme", "https"},
+        {":path", "/index.html"},
+        {":authority", "www.example.com"},
+        {"custom-key", "custom-value"}},
+     {{"custom-key", "custom-value"}, {"cache-control", "no-cache"}, {":authority", "www.example.com"}},
+     164}
+                 });
+}
+
+TEST_CASE("C.5. Response Examples without Huffman Coding")
+{
+  // https://datatracker.ietf.org/doc/html/rfc7541#appendix-C.5
+  //
+  check_examples(256,
+                 {
+    {{
+       0x48, 0x03, 0x33, 0x30, 0x32, 0x58, 0x07, 0x70, 0x72, 0x69, 0x76, 0x61, 0x74, 0x65,
+       0x61, 0x1d, 0x4d, 0x6f, 0x6e, 0x2c, 0x20, 0x32, 0x31, 0x20, 0x4f, 0x63, 0x74, 0x20,
+       0x32, 0x30, 0x31, 0x33, 0x20, 0x32, 0x30, 0x3a, 0x31, 0x33, 0x3a, 0x32, 0x31, 0x20,
+       0x47, 0x4d, 0x54, 0x6e, 0x17, 0x68, 0x74, 0x74, 0x70, 0x73, 0x3a, 0x2f, 0x2f, 0x77,
+       0x77, 0x77, 0x2e, 0x65, 0x78, 0x61, 0x6d, 0x70, 0x6c, 0x65, 0x2e, 0x63, 0x6f, 0x6d},
+     {{":status", "302"},
+        {"cache-control", "private"},
+        {"date", "Mon, 21 Oct 2013 20:13:21 GMT"},
+        {"location", "https://www.example.com"}},
+     {{"location", "https://www.example.com"},
+        {"date", "Mon, 21 Oct 2013 20:13:21 GMT"},
+        {"cache-control", "private"},
+        {":status", "302"}},
+     222},
+    {{
+       0x48, 0x03, 0x33, 0x30, 0x37, 0xc1, 0xc0, 0xbf},
+     {{":status", "307"},
+        {"cache-control", "private"},
+        {"date", "Mon, 21 Oct 2013 20:13:21 GMT"},
+        {"location", "https://www.example.com"}},
+     {{":status", "307"},
+        {"location", "https://www.example.com"},
+        {"date", "Mon, 21 Oct 2013 20:13:21 GMT"},
+        {"cache-control", "private"}},
+     222},
+    {{
+       0x88, 0xc1, 0x61, 0x1d, 0x4d, 0x6f, 0x6e, 0x2c, 0x20, 0x32, 0x31, 0x20, 0x4f, 0x63,
+       0x74, 0x20, 0x32, 0x30, 0x31, 0x33, 0x20, 0x32, 0x30, 0x3a, 0x31, 0x33, 0x3a, 0x32,
+       0x32, 0x20, 0x47, 0x4d, 0x54, 0xc0, 0x5a, 0x04, 0x67, 0x7a, 0x69, 0x70, 0x77, 0x38,
+       0x66, 0x6f, 0x6f, 0x3d, 0x41, 0x53, 0x44, 0x4a, 0x4b, 0x48, 0x51, 0x4b, 0x42, 0x5a,
+       0x58, 0x4f, 0x51, 0x57, 0x45, 0x4f, 0x50, 0x49, 0x55, 0x41, 0x58, 0x51, 0x57, 0x45,
+       0x4f, 0x49, 0x55, 0x3b, 0x20, 0x6d, 0x61, 0x78, 0x2d, 0x61, 0x67, 0x65, 0x3d, 0x33,
+       0x36, 0x30, 0x30, 0x3b, 0x20, 0x76, 0x65, 0x72, 0x73, 0x69, 0x6f, 0x6e, 0x3d, 0x31},
+     {{":status", "200"},
+        {"cache-control", "private"},
+        {"date", "Mon, 21 Oct 2013 20:13:22 GMT"},
+        {"location", "https://www.example.com"},
+        {"content-encoding", "gzip"},
+        {"set-cookie", "foo=ASDJKHQKBZXOQWEOPIUAXQWEOIU; max-age=3600; version=1"}},
+     {{"set-cookie", "foo=ASDJKHQKBZXOQWEOPIUAXQWEOIU; max-age=3600; version=1"},
+        {"content-encoding", "gzip"},
+        {"date", "Mon, 21 Oct 2013 20:13:22 GMT"}},
+     215}
+                 });
+}
+
+TEST_CASE("C.6. Response Examples with Huffman Coding")
+{
+  // https://datatracker.ietf.org/doc/html/rfc7541#appendix-C.6
+  //
+  check_examples(256,
+                 {
+    {{
+       0x48, 0x82, 0x64, 0x02, 0x58, 0x85, 0xae, 0xc3, 0x77, 0x1a, 0x4b, 0x61, 0x96, 0xd0,
+       0x7a, 0xbe, 0x94, 0x10, 0x54, 0xd4, 0x44, 0xa8, 0x20, 0x05, 0x95, 0x04, 0x0b, 0x81,
+       0x66, 0xe0, 0x82, 0xa6, 0x2d, 0x1b, 0xff, 0x6e, 0x91, 0x9d, 0x29, 0xad, 0x17, 0x18,
+       0x63, 0xc7, 0x8f, 0x0b, 0x97, 0xc8, 0xe9, 0xae, 0x82, 0xae, 0x43, 0xd3},
+     {{":status", "302"},
+        {"cache-control", "private"},
+        {"date", "Mon, 21 Oct 2013 20:13:21 GMT"},
+        {"location", "https://www.example.com"}},
+     {{"location", "https://www.example.com"},
+        {"date", "Mon, 21 Oct 2013 20:13:21 GMT"},
+        {"cache-control", "private"},
+        {":status", "302"}},
+     222},
+    {{
+       0x48, 0x83, 0x64, 0x0e, 0xff, 0xc1, 0xc0, 0xbf},
+     {{":status", "307"},
+        {"cache-control", "private"},
+        {"date", "Mon, 21 Oct 2013 20:13:21 GMT"},
+        {"location", "https://www.example.com"}},
+     {{":status", "307"},
+        {"location", "https://www.example.com"},
+        {"date", "Mon, 21 Oct 2013 20:13:21 GMT"},
+        {"cache-control", "private"}},
+     222},
+    {{
+       0x88, 0xc1, 0x61, 0x96, 0xd0, 0x7a, 0xbe, 0x94, 0x10, 0x54, 0xd4, 0x44, 0xa8, 0x20,
+       0x05, 0x95, 0x04, 0x0b, 0x81, 0x66, 0xe0, 0x84, 0xa6, 0x2d, 0x1b, 0xff, 0xc0, 0x5a,
+       0x83, 0x9b, 0xd9, 0xab, 0x77, 0xad, 0x94, 0xe7, 0x82, 0x1d, 0xd7, 0xf2, 0xe6, 0xc7,
+       0xb3, 0x35, 0xdf, 0xdf, 0xcd, 0x5b, 0x39, 0x60, 0xd5, 0xaf, 0x27, 0x08, 0x7f, 0x36,
+       0x72, 0xc1, 0xab, 0x27, 0x0f, 0xb5, 0x29, 0x1f, 0x95, 0x87, 0x31, 0x60, 0x65, 0xc0,
+       0x03, 0xed, 0x4e, 0xe5, 0xb1, 0x06, 0x3d, 0x50, 0x07},
+     {{":status", "200"},
+        {"cache-control", "private"},
+        {"date", "Mon, 21 Oct 2013 20:13:22 GMT"},
+        {"location", "https://www.example.com"},
+        {"content-encoding", "gzip"},
+        {"set-cookie", "foo=ASDJKHQKBZXOQWEOPIUAXQWEOIU; max-age=3600; version=1"}},
+     {{"set-cookie", "foo=ASDJKHQKBZXOQWEOPIUAXQWEOIU; max-age=3600; version=1"},
+        {"content-encoding", "gzip"},
+        {"date", "Mon, 21 Oct 2013 20:13:22 GMT"}},
+     215}
+                 });
+}
+
+TEST_CASE("Raw string literals should be handed out as views into the input")
+{
+  // literal without indexing, new name "custom-key", value "custom-header"
+  //
+  auto const block = std::vector<u8>{0x00, 0x0a, 'c', 'u', 's', 't', 'o', 'm', '-', 'k', 'e', 'y', 0x0d, 'c',
+                                     'u',  's',  't', 'o', 'm', '-', 'h', 'e', 'a', 'd', 'e', 'r', 0x82};
+
+  auto const* const first = reinterpret_cast<char const*>(block.data());
+  auto const* const last  = first + block.size();
+
+  auto d  = potok::hpack::block_decoder();
+  auto ec = boost::system::error_code();
+
+  auto num_fields = usize{0};
+  d(potok::span<u8 const>(block),
+    [&](potok::hpack::header_field const& field) {
+      if (num_fields++ == 0) {
+        CHECK(field.name == "custom-key");
+        CHECK(field.value == "custom-header");
+        CHECK((field.name.data() >= first && field.name.data() < last));
+        CHECK((field.value.data() >= first && field.value.data() < last));
+      }
+      else {
+        CHECK(field.name == ":method");
+        CHECK(field.value == "GET");
+      }
+    },
+    ec);
+
+  CHECK(!ec);
+  CHECK(num_fields == 2);
+  CHECK(d.table().size() == 0);
+
+  d.finish(ec);
+  CHECK(!ec);
+}
+
+TEST_CASE("Header blocks should decode the same across any buffer sequence")
+{
+  // C.3.3 after C.3.1 and C.3.2 split into uneven pieces, including empty ones
+  //
+  auto const blocks = std::array<std::vector<u8>, 3>{{
+      {0x82, 0x86, 0x84, 0x41, 0x0f, 0x77, 0x77, 0x77, 0x2e, 0x65, 0x78, 0x61, 0x6d, 0x70, 0x6c, 0x65, 0x2e, 0x63,
+       0x6f, 0x6d},
+      {0x82, 0x86, 0x84, 0xbe, 0x58, 0x08, 0x6e, 0x6f, 0x2d, 0x63, 0x61, 0x63, 0x68, 0x65},
+      {0x82, 0x87, 0x85, 0xbf, 0x40, 0x0a, 0x63, 0x75, 0x73, 0x74, 0x6f, 0x6d, 0x2d, 0x6b, 0x65, 0x79, 0x0c, 0x63,
+       0x75, 0x73, 0x74, 0x6f, 0x6d, 0x2d, 0x76, 0x61, 0x6c, 0x75, 0x65},
+  }};
+
+  auto d  = potok::hpack::block_decoder();
+  auto ec = boost::system::error_code();
+
+  auto out      = fields();
+  auto on_field = [&](potok::hpack::header_field const& field) {
+    out.emplace_back(std::string(field.name), std::string(field.value));
+  };
+
+  for (auto const& block : blocks) {
+    out.clear();
+
+    auto const* p   = block.data();
+    auto const  seq = std::array<boost::asio::const_buffer, 5>{
+        boost::asio::const_buffer(p, 3),
+        boost::asio::const_buffer(p + 3, 0),
+        boost::asio::const_buffer(p + 3, 4),
+        boost::asio::const_buffer(p + 7, 1),
+        boost::asio::const_buffer(p + 8, block.size() - 8),
+    };
+
+    CHECK(d(seq, on_field, ec) == block.size());
+    CHECK(!ec);
+
+    d.finish(ec);
+    CHECK(!ec);
+  }
+
+  CHECK(out == fields{{":method", "GET"},
+                      {":scheme", "https"},
+                      {":path", "/index.html"},
+                      {":authority", "www.example.com"},
+                      {"custom-key", "custom-value"}});
+}
+
+TEST_CASE("Never-indexed literals should be flagged as sensitive and kept out of the table")
+{
+  // C.2.3: literal never indexed, new name "password", value "secret"
+  //
+  auto const block = std::vector<u8>{0x10, 0x08, 0x70, 0x61, 0x73, 0x73, 0x77, 0x6f, 0x72,
+                                     0x64, 0x06, 0x73, 0x65, 0x63, 0x72, 0x65, 0x74};
+
+  auto d  = potok::hpack::block_decoder();
+  auto ec = boost::system::error_code();
+
+  auto num_fields = usize{0};
+  d(potok::span<u8 const>(block),
+    [&](potok::hpack::header_field const& field) {
+      ++num_fields;
+      CHECK(field.name == "password");
+      CHECK(field.value == "secret");
+      CHECK(field.sensitive);
+    },
+    ec);
+
+  CHECK(!ec);
+  CHECK(num_fields == 1);
+  CHECK(d.table().size() == 0);
+}
+
+TEST_CASE("Dynamic table size updates should only be accepted at the start of a block and within the limit")
+{
+  auto const ignore = [](potok::hpack::header_field const&) {};
+
+  auto ec = boost::system::error_code();
+
+  // C.3.1 fills the table, then a size update to 0 followed by one back to 4096 empties it
+  //
+  auto d = potok::hpack::block_decoder();
+  d(potok::span<u8 const>(std::vector<u8>{0x82, 0x86, 0x84, 0x41, 0x03, 'f', 'o', 'o'}), ignore, ec);
+  CHECK(!ec);
+  d.finish(ec);
+  CHECK(d.table().size() == 1);
+
+  d(potok::span<u8 const>(std::vector<u8>{0x20, 0x3f, 0xe1, 0x1f, 0x82}), ignore, ec);
+  CHECK(!ec);
+  CHECK(d.table().size() == 0);
+  CHECK(d.table().max_size() == 4096);
+  d.finish(ec);
+
+  // one more than the limit
+  //
+  d(potok::span<u8 const>(std::vector<u8>{0x3f, 0xe2, 0x1f}), ignore, ec);
+  CHECK(ec == potok::hpack::error::limit_exceeded);
+
+  // after a field
+  //
+  auto d2 = potok::hpack::block_decoder();
+  d2(potok::span<u8 const>(std::vector<u8>{0x82, 0x20}), ignore, ec);
+  CHECK(ec == potok::hpack::error::unexpected_size_update);
+
+  // a prefix-only value can exceed a small limit too
+  //
+  auto d3 = potok::hpack::block_decoder(16);
+  d3(potok::span<u8 const>(std::vector<u8>{0x31}), ignore, ec);
+  CHECK(ec == potok::hpack::error::limit_exceeded);
+}
+
+TEST_CASE("Malformed header blocks should be rejected")
+{
+  using potok::hpack::error;
+
+  auto const ignore = [](potok::hpack::header_field const&) {};
+
+  auto const decode = [&](std::vector<u8> const& block, usize const max_string_size = 1024) {
+    auto d  = potok::hpack::block_decoder(4096, max_string_size);
+    auto ec = boost::system::error_code();
+
+    d(potok::span<u8 const>(block), ignore, ec);
+    if (!ec) { d.finish(ec); }
+    return ec;
+  };
+
+  CHECK(decode({0x80}) == error::invalid_index);
+  CHECK(decode({0x82, 0x80}) == error::invalid_index);
+  CHECK(decode({0xbe}) == error::invalid_index);
+  CHECK(decode({0xff, 0x00}) == error::invalid_index);
+  CHECK(decode({0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x01}) == error::invalid_index);
+  CHECK(decode({0x7e, 0x01, 'a'}) == error::invalid_index);
+
+  CHECK(decode({0x82, 0x41}) == error::incomplete_header_block);
+  CHECK(decode({0x41, 0x03, 'a', 'b'}) == error::incomplete_header_block);
+  CHECK(decode({0x40, 0x01, 'a'}) == error::incomplete_header_block);
+  CHECK(decode({0xff}) == error::incomplete_header_block);
+
+  CHECK(decode({0x41, 0x7f, 0x00}, 64) == error::limit_exceeded);
+  CHECK(decode({0x40, 0x05, 'a', 'b', 'c', 'd', 'e', 0x00}, 4) == error::limit_exceeded);
+
+  // an EOS symbol and bad padding in Huffman-coded literals
+  //
+  CHECK(decode({0x41, 0x84, 0xff, 0xff, 0xff, 0xff}) == error::huffman_eos);
+  CHECK(decode({0x41, 0x81, 0x00}) == error::huffman_invalid_padding);
+
+  CHECK(decode({}) == boost::system::error_code());
+  CHECK(decode({0x41, 0x00}) == boost::system::error_code());
+  CHECK(decode({0x40, 0x00, 0x80}) == boost::system::error_code());
+}
+
+TEST_CASE("Forbidden characters in names and values should only be rejected when asked for")
+{
+  using potok::hpack::error;
+
+  auto const ignore = [](potok::hpack::header_field const&) {};
+
+  auto const decode = [&](std::vector<u8> const& block, bool const validate_fields, usize const chunk_size) {
+    auto d  = potok::hpack::block_decoder(4096, potok::hpack::default_max_string_size,
+                                          potok::hpack::huffman_lookup::multi_symbol, validate_fields);
+    auto ec = boost::system::error_code();
+
+    for (usize pos = 0; pos < block.size() && !ec; pos += chunk_size) {
+      auto const n = std::min(chunk_size, block.size() - pos);
+      d(potok::span<u8 const>(block.data() + pos, n), ignore, ec);
+    }
+    if (!ec) { d.finish(ec); }
+    return ec;
+  };
+
+  // an uppercase name, Huffman-coded ('A' is 100001) and raw, and a raw value with a line feed in it
+  //
+  auto const huffman_name = std::vector<u8>{0x40, 0x81, 0b100001'11, 0x01, 'v'};
+  auto const raw_name     = std::vector<u8>{0x40, 0x03, 'a', 'B', 'c', 0x01, 'v'};
+  auto const raw_value    = std::vector<u8>{0x40, 0x01, 'n', 0x03, 'a', '\n', 'b'};
+
+  // a colon or a space is fine in a value but not in a name
+  //
+  auto const value_only = std::vector<u8>{0x40, 0x01, 'n', 0x03, 'a', ':', ' '};
+
+  for (usize const chunk_size : {usize{1}, usize{3}, usize{4096}}) {
+    CHECK(decode(huffman_name, true, chunk_size) == error::invalid_field_name);
+    CHECK(decode(raw_name, true, chunk_size) == error::invalid_field_name);
+    CHECK(decode(raw_value, true, chunk_size) == error::invalid_field_value);
+    CHECK(decode(value_only, true, chunk_size) == boost::system::error_code());
+
+    CHECK(decode(huffman_name, false, chunk_size) == boost::system::error_code());
+    CHECK(decode(raw_name, false, chunk_size) == boost::system::error_code());
+    CHECK(decode(raw_value, false, chunk_size) == boost::system::error_code());
+  }
+}
@@ -0,0 +1,378 @@
+#define CATCH_CONFIG_MAIN
+#include "catch_amalgamated.hpp"
+
+#include <potok/hpack/block_decoder.hpp>
+#include <potok/hpack/block_encoder.hpp>
+#include <potok/hpack/error.hpp>
+#include <potok/hpack/header_field.hpp>
+
+#include <potok/span.hpp>
+#include <potok/stdint.hpp>
+
+#include <boost/asio/buffer.hpp>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace potok::ints;
+
+namespace {
+
+using fields = std::vector<std::pair<std::string, std::string>>;
+
+// indexes everything it can, like the examples from RFC 7541 Appendix C
+//
+struct always_incremental_policy {
+  auto operator()(potok::hpack::header_field const& field, potok::hpack::dynamic_table const&) const
+      -> potok::hpack::indexing
+  {
+    return field.sensitive ? potok::hpack::indexing::never : potok::hpack::indexing::incremental;
+  }
+};
+
+auto to_header_fields(fields const& fs) -> std::vector<potok::hpack::header_field>
+{
+  auto out = std::vector<potok::hpack::header_field>();
+  for (auto const& [name, value] : fs) { out.push_back({name, value}); }
+  return out;
+}
+
+// encodes `fs` as one header block into buffers of `chunk_size` octets, each in a call of its own as if it were the
+// payload of its own frame
+//
+template <class Encoder>
+auto encode_block(Encoder& e, std::vector<potok::hpack::header_field> const& fs, usize const chunk_size)
+    -> std::vector<u8>
+{
+  auto out = std::vector<u8>();
+
+  auto remaining = potok::span<potok::hpack::header_field const>(fs);
+  auto ec        = boost::system::error_code();
+  do {
+    auto chunk = std::vector<u8>(chunk_size);
+
+    auto       num_encoded = usize{0};
+    auto const n = e(remaining, boost::asio::mutable_buffer(chunk.data(), chunk.size()), num_encoded, ec);
+    REQUIRE((!ec || ec == potok::hpack::error::needs_more));
+    REQUIRE(n <= chunk_size);
+
+    out.insert(out.end(), chunk.begin(), chunk.begin() + static_cast<std::ptrdiff_t>(n));
+    remaining = remaining.subspan(num_encoded);
+  } while (ec);
+
+  e.finish();
+  return out;
+}
+
+// decodes `block` into copies of its fields, along with whether each one was never-indexed if `sensitive` is given
+//
+auto decode_block(potok::hpack::block_decoder& d, std::vector<u8> const& block, std::vector<bool>* sensitive = nullptr)
+    -> fields
+{
+  auto out = fields();
+  auto ec  = boost::system::error_code();
+  d(potok::span<u8 const>(block),
+    [&](potok::hpack::header_field const& field) {
+      out.emplace_back(std::string(field.name), std::string(field.value));
+      if (sensitive) { sensitive->push_back(field.sensitive); }
+    },
+    ec);
+  REQUIRE(!ec);
+
+  d.finish(ec);
+  REQUIRE(!ec);
+  return out;
+}
+
+auto table_entries(potok::hpack::dynamic_table const& table) -> fields
+{
+  auto out = fields();
+  for (usize i = 0; i < table.size(); ++i) {
+    out.emplace_back(std::string(table[i].name), std::string(table[i].value));
+  }
+  return out;
+}
+
+auto to_fields(std::vector<potok::hpack::header_field> const& fs) -> fields
+{
+  auto out = fields();
+  for (auto const& field : fs) { out.emplace_back(std::string(field.name), std::string(field.value)); }
+  return out;
+}
+
+auto sensitivity(std::vector<potok::hpack::header_field> const& fs) -> std::vector<bool>
+{
+  auto out = std::vector<bool>();
+  for (auto const& field : fs) { out.push_back(field.sensitive); }
+  return out;
+}
+
+}    // namespace
+
+TEST_CASE("C.4. Request Examples with Huffman Coding should be reproduced exactly")
+{
+  // https://datatracker.ietf.org/doc/html/rfc7541#appendix-C.4
+  //
+  for (usize const chunk_size : {usize{1}, usize{3}, usize{4096}}) {
+    auto e = potok::hpack::block_encoder<always_incremental_policy>();
+
+    auto const req1 =
+        fields{{":method", "GET"}, {":scheme", "http"}, {":path", "/"}, {":authority", "www.example.com"}};
+
+    auto req2 = req1;
+    req2.emplace_back("cache-control", "no-cache");
+
+    auto req3 = fields{{":method", "GET"},
+                       {":scheme", "https"},
+                       {":path", "/index.html"},
+                       {":authority", "www.example.com"},
+                       {"custom-key", "custom-value"}};
+
+    CHECK(encode_block(e, to_header_fields(req1), chunk_size) == std::vector<u8>{
+          0x82, 0x86, 0x84, 0x41, 0x8c, 0xf1, 0xe3, 0xc2, 0xe5, 0xf2, 0x3a, 0x6b, 0xa0, 0xab,
+          0x90, 0xf4, 0xff});
+
+    CHECK(encode_block(e, to_header_fields(req2), chunk_size) == std::vector<u8>{
+          0x82, 0x86, 0x84, 0xbe, 0x58, 0x86, 0xa8, 0xeb, 0x10, 0x64, 0x9c, 0xbf});
+
+    CHECK(encode_block(e, to_header_fields(req3), chunk_size) == std::vector<u8>{
+          0x82, 0x87, 0x85, 0xbf, 0x40, 0x88, 0x25, 0xa8, 0x49, 0xe9, 0x5b, 0xa9, 0x7d, 0x7f,
+          0x89, 0x25, 0xa8, 0x49, 0xe9, 0x5b, 0xb8, 0xe8, 0xb4, 0xbf});
+
+    CHECK(table_entries(e.table()) ==
+          fields{{"custom-key", "custom-value"}, {"cache-control", "no-cache"}, {":authority", "www.example.com"}});
+    CHECK(e.table().num_octets() == 164);
+  }
+}
+
+TEST_CASE("C.6. Response Examples with Huffman Coding should be reproduced exactly")
+{
+  // https://datatracker.ietf.org/doc/html/rfc7541#appendix-C.6
+  //
+  auto e = potok::hpack::block_encoder<always_incremental_policy>(256);
+
+  auto const resp1 = fields{{":status", "302"},
+                            {"cache-control", "private"},
+                            {"date", "Mon, 21 Oct 2013 20:13:21 GMT"},
+                            {"location", "https://www.example.com"}};
+
+  auto resp2        = resp1;
+  resp2[0].second   = "307";
+
+  auto const resp3 = fields{{":status", "200"},
+                            {"cache-control", "private"},
+                            {"date", "Mon, 21 Oct 2013 20:13:22 GMT"},
+                            {"location", "https://www.example.com"},
+                            {"content-encoding", "gzip"},
+                            {"set-cookie", "foo=ASDJKHQKBZXOQWEOPIUAXQWEOIU; max-age=3600; version=1"}};
+
+  CHECK(encode_block(e, to_header_fields(resp1), 4096) == std::vector<u8>{
+          0x48, 0x82, 0x64, 0x02, 0x58, 0x85, 0xae, 0xc3, 0x77, 0x1a, 0x4b, 0x61, 0x96, 0xd0,
+          0x7a, 0xbe, 0x94, 0x10, 0x54, 0xd4, 0x44, 0xa8, 0x20, 0x05, 0x95, 0x04, 0x0b, 0x81,
+          0x66, 0xe0, 0x82, 0xa6, 0x2d, 0x1b, 0xff, 0x6e, 0x91, 0x9d, 0x29, 0xad, 0x17, 0x18,
+          0x63, 0xc7, 0x8f, 0x0b, 0x97, 0xc8, 0xe9, 0xae, 0x82, 0xae, 0x43, 0xd3});
+
+  // unlike the RFC, "307" is sent raw since Huffman-coding it doesn't make it any shorter
+  //
+  CHECK(encode_block(e, to_header_fields(resp2), 4096) == std::vector<u8>{0x48, 0x03, '3', '0', '7', 0xc1, 0xc0, 0xbf});
+
+  CHECK(encode_block(e, to_header_fields(resp3), 4096) == std::vector<u8>{
+          0x88, 0xc1, 0x61, 0x96, 0xd0, 0x7a, 0xbe, 0x94, 0x10, 0x54, 0xd4, 0x44, 0xa8, 0x20,
+          0x05, 0x95, 0x04, 0x0b, 0x81, 0x66, 0xe0, 0x84, 0xa6, 0x2d, 0x1b, 0xff, 0xc0, 0x5a,
+          0x83, 0x9b, 0xd9, 0xab, 0x77, 0xad, 0x94, 0xe7, 0x82, 0x1d, 0xd7, 0xf2, 0xe6, 0xc7,
+          0xb3, 0x35, 0xdf, 0xdf, 0xcd, 0x5b, 0x39, 0x60, 0xd5, 0xaf, 0x27, 0x08, 0x7f, 0x36,
+          0x72, 0xc1, 0xab, 0x27, 0x0f, 0xb5, 0x29, 0x1f, 0x95, 0x87, 0x31, 0x60, 0x65, 0xc0,
+          0x03, 0xed, 0x4e, 0xe5, 0xb1, 0x06, 0x3d, 0x50, 0x07});
+
+  CHECK(e.table().num_octets() == 215);
+}
+
+TEST_CASE("Encoded header blocks should decode back to the same fields and tables with every policy")
+{
+  auto rng = std::mt19937(1337);
+
+  auto const names  = std::vector<std::string>{":status", "content-type", "content-length", "server", "date",
+                                              "cache-control", "set-cookie", "x-request-id", "etag", "vary",
+                                              "cookie", "authorization", "x-custom-header-with-a-long-name"};
+  auto const values = std::vector<std::string>{"200", "404", "text/html; charset=utf-8", "nginx", "gzip", "",
+                                               "Mon, 21 Oct 2013 20:13:21 GMT", "max-age=3600", "abc", "\x01\xff",
+                                               std::string(300, 'x'), "a-value-that-might-evict-things"};
+
+  auto pick = [&](auto const& v) -> auto const& {
+    return v[std::uniform_int_distribution<usize>(0, v.size() - 1)(rng)];
+  };
+
+  auto const run = [&](auto& e, usize const table_size) {
+    auto d = potok::hpack::block_decoder(table_size);
+    for (usize n = 0; n < 100; ++n) {
+      if (n % 17 == 16) { e.set_max_table_size(std::uniform_int_distribution<usize>(0, table_size)(rng)); }
+
+      auto fs = std::vector<potok::hpack::header_field>();
+      for (usize i = std::uniform_int_distribution<usize>(0, 12)(rng); i > 0; --i) {
+        fs.push_back({pick(names), pick(values), i % 5 == 0});
+      }
+
+      auto const block     = encode_block(e, fs, std::uniform_int_distribution<usize>(1, 64)(rng));
+      auto       sensitive = std::vector<bool>();
+      REQUIRE(decode_block(d, block, &sensitive) == to_fields(fs));
+
+      // the policy may flag more fields as sensitive, but never fewer
+      //
+      for (usize i = 0; i < fs.size(); ++i) { REQUIRE(sensitive[i] >= fs[i].sensitive); }
+
+      REQUIRE(table_entries(e.table()) == table_entries(d.table()));
+      REQUIRE(e.table().num_octets() == d.table().num_octets());
+    }
+  };
+
+  auto e1 = potok::hpack::block_encoder<>();
+  run(e1, 4096);
+
+  auto e2 = potok::hpack::block_encoder<potok::hpack::static_only_indexing_policy>();
+  run(e2, 4096);
+  CHECK(e2.table().size() == 0);
+
+  auto e3 = potok::hpack::block_encoder<always_incremental_policy>(512);
+  run(e3, 512);
+}
+
+TEST_CASE("Dynamic table size updates should start the next header block")
+{
+  auto e = potok::hpack::block_encoder<always_incremental_policy>();
+  auto d = potok::hpack::block_decoder();
+
+  auto const x_a    = fields{{"x-a", "1"}};
+  auto const status = fields{{":status", "200"}};
+
+  decode_block(d, encode_block(e, to_header_fields(x_a), 4096));
+  CHECK(e.table().size() == 1);
+
+  // the table is cleared by the smaller of the two sizes, which must be signalled first
+  //
+  e.set_max_table_size(100);
+  e.set_max_table_size(0);
+  e.set_max_table_size(4096);
+
+  auto const block = encode_block(e, to_header_fields(status), 4096);
+  CHECK(block == std::vector<u8>{0x20, 0x3f, 0xe1, 0x1f, 0x88});
+  CHECK(e.table().size() == 0);
+
+  decode_block(d, block);
+  CHECK(d.table().size() == 0);
+
+  // the smaller size is signalled even when it doesn't evict anything, as RFC 7541 section 4.2 requires
+  //
+  e.set_max_table_size(1024);
+  e.set_max_table_size(2048);
+  CHECK(encode_block(e, to_header_fields(status), 4096) ==
+        std::vector<u8>{0x3f, 0xe1, 0x07, 0x3f, 0xe1, 0x0f, 0x88});
+  CHECK(e.table().max_size() == 2048);
+
+  // down to 0 and back while the table is empty, which a strict decoder insists on seeing
+  //
+  e.set_max_table_size(0);
+  e.set_max_table_size(4096);
+  auto const round_trip = encode_block(e, to_header_fields(status), 4096);
+  CHECK(round_trip == std::vector<u8>{0x20, 0x3f, 0xe1, 0x1f, 0x88});
+  decode_block(d, round_trip);
+
+  // a single update for a single size
+  //
+  e.set_max_table_size(1024);
+  CHECK(encode_block(e, to_header_fields(status), 4096) == std::vector<u8>{0x3f, 0xe1, 0x07, 0x88});
+}
+
+TEST_CASE("The indexing policy should see the table the field is encoded against")
+{
+  // records the table size each field was judged against
+  //
+  struct recording_policy {
+    std::vector<usize>* max_sizes = nullptr;
+
+    auto operator()(potok::hpack::header_field const&, potok::hpack::dynamic_table const& table) const
+        -> potok::hpack::indexing
+    {
+      max_sizes->push_back(table.max_size());
+      return potok::hpack::indexing::incremental;
+    }
+  };
+
+  auto max_sizes = std::vector<usize>();
+  auto e         = potok::hpack::block_encoder<recording_policy>(4096, recording_policy{&max_sizes});
+
+  auto const fs = fields{{"x-a", "1"}, {"x-b", "2"}};
+  encode_block(e, to_header_fields(fs), 4096);
+
+  e.set_max_table_size(256);
+  encode_block(e, to_header_fields(fs), 4096);
+
+  CHECK(max_sizes == std::vector<usize>{4096, 4096, 256, 256});
+}
+
+TEST_CASE("The response policy should keep volatile and sensitive fields out of the dynamic table")
+{
+  auto e = potok::hpack::block_encoder<>();
+  auto d = potok::hpack::block_decoder();
+
+  auto const response = fields{{":status", "200"},
+                               {"content-type", "text/html"},
+                               {"content-length", "1234"},
+                               {"set-cookie", "id=a3fWa; Max-Age=2592000"},
+                               {"authorization", "Basic Zm9vOmJhcg=="},
+                               {"x-large", std::string(4000, 'x')}};
+
+  auto fs = to_header_fields(response);
+  fs.push_back({"x-secret", "hunter2", true});
+
+  auto sensitive = std::vector<bool>();
+  CHECK(decode_block(d, encode_block(e, fs, 4096), &sensitive) == to_fields(fs));
+
+  // authorization is never indexed too
+  //
+  auto expected_sensitive = sensitivity(fs);
+  expected_sensitive[4]   = true;
+  CHECK(sensitive == expected_sensitive);
+
+  CHECK(table_entries(e.table()) == fields{{"content-type", "text/html"}});
+
+  // indexed from here on
+  //
+  auto const again = encode_block(e, to_header_fields({response[1]}), 4096);
+  CHECK(again == std::vector<u8>{0xbe});
+}
+
+TEST_CASE("A field that doesn't fit should be finished in the next buffer")
+{
+  auto e = potok::hpack::block_encoder<>();
+
+  auto const request = fields{{"x-a", std::string(100, 'a')}, {":status", "200"}};
+  auto const fs      = to_header_fields(request);
+
+  auto buf1 = std::vector<u8>(10);
+  auto buf2 = std::vector<u8>(200);
+
+  auto num_encoded = usize{0};
+  auto ec          = boost::system::error_code();
+
+  auto n = e(fs, boost::asio::mutable_buffer(buf1.data(), buf1.size()), num_encoded, ec);
+  CHECK(ec == potok::hpack::error::needs_more);
+  CHECK(n == 10);
+  CHECK(num_encoded == 1);
+
+  auto const rest = potok::span<potok::hpack::header_field const>(fs).subspan(num_encoded);
+
+  n = e(rest, boost::asio::mutable_buffer(buf2.data(), buf2.size()), num_encoded, ec);
+  CHECK(!ec);
+  CHECK(num_encoded == 1);
+  e.finish();
+
+  buf1.insert(buf1.end(), buf2.begin(), buf2.begin() + static_cast<std::ptrdiff_t>(n));
+
+  auto d = potok::hpack::block_decoder();
+  auto sensitive = std::vector<bool>();
+  CHECK(decode_block(d, buf1, &sensitive) == request);
+  CHECK(sensitive == sensitivity(fs));
+}
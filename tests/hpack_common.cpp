@@ -4,6 +4,65 @@
 #include <potok/hpack/common.hpp>
 #include <potok/stdint.hpp>
 
+#include <limits>
+#include <vector>
+
 static_assert(potok::hpack::get_num_required_octets(14, 5) == 1);
 static_assert(potok::hpack::get_num_required_octets(35, 5) == 2);
-static_assert(potok::hpack::get_num_required_octets(std::numeric_limits<potok::u64>::max(), 1) == 11);
\ No newline at end of file
+static_assert(potok::hpack::get_num_required_octets(std::numeric_limits<potok::u64>::max(), 1) == 11);
+
+using namespace potok::ints;
+
+namespace {
+
+// the original iterative definition, kept around as a reference for the table-driven version
+//
+auto reference_num_required_octets(u64 const x, u8 const num_prefix_bits) -> u32
+{
+  u64 const max_prefix_value = (u64{1} << num_prefix_bits) - 1;
+
+  if (x < max_prefix_value) { return 1; }
+
+  auto I = x - max_prefix_value;
+
+  auto count = 1;
+  while (I >= 128) {
+    ++count;
+    I /= 128;
+  }
+  ++count;
+  return count;
+}
+
+}    // namespace
+
+TEST_CASE("get_num_required_octets should match the iterative algorithm for every small integer")
+{
+  for (unsigned i = 0; i < 8; ++i) {
+    auto const num_prefix_bits = static_cast<u8>(1 + i);
+
+    for (u64 x = 0; x < (u64{1} << 16); ++x) {
+      REQUIRE(potok::hpack::get_num_required_octets(x, num_prefix_bits) ==
+              reference_num_required_octets(x, num_prefix_bits));
+    }
+  }
+}
+
+TEST_CASE("get_num_required_octets should match the iterative algorithm around every power of two")
+{
+  for (unsigned i = 0; i < 8; ++i) {
+    auto const num_prefix_bits  = static_cast<u8>(1 + i);
+    auto const max_prefix_value = potok::hpack::get_max_prefix_value(num_prefix_bits);
+
+    auto values = std::vector<u64>{std::numeric_limits<u64>::max(), std::numeric_limits<u64>::max() - 1};
+    for (unsigned k = 0; k < 64; ++k) {
+      auto const p = u64{1} << k;
+      for (auto const x : {p - 1, p, p + 1, p - 1 + max_prefix_value, p + max_prefix_value}) { values.push_back(x); }
+    }
+
+    for (auto const x : values) {
+      REQUIRE(potok::hpack::get_num_required_octets(x, num_prefix_bits) ==
+              reference_num_required_octets(x, num_prefix_bits));
+    }
+  }
+}
@@ -0,0 +1,88 @@
+#define CATCH_CONFIG_MAIN
+#include "catch_amalgamated.hpp"
+
+#include <potok/hpack/decode.hpp>
+#include <potok/hpack/kernels.hpp>
+
+#include <potok/cpu.hpp>
+
+#include <potok/span.hpp>
+#include <potok/stdint.hpp>
+
+#include <random>
+#include <vector>
+
+using namespace potok::ints;
+
+TEST_CASE("C.3.2. Second Request: the leading indexed fields should be found as one run")
+{
+  // https://datatracker.ietf.org/doc/html/rfc7541#appendix-C.3.2
+  //
+  auto const octets  = std::vector<u8>{0x82, 0x86, 0x84, 0xbe, 0x58, 0x08, 0x6e, 0x6f};
+  auto       indices = std::vector<u8>(octets.size());
+
+  auto const n = potok::hpack::decode_indexed_run(octets, indices);
+  REQUIRE(n == 4);
+  CHECK(indices[0] == 2);
+  CHECK(indices[1] == 6);
+  CHECK(indices[2] == 4);
+  CHECK(indices[3] == 62);
+}
+
+TEST_CASE("A run should stop at index 0 and at indices needing continuation octets")
+{
+  auto indices = std::vector<u8>(64);
+
+  {
+    auto octets = std::vector<u8>(40, 0x82);
+    octets[37]  = 0x80;
+    CHECK(potok::hpack::decode_indexed_run(octets, indices) == 37);
+  }
+
+  {
+    auto octets = std::vector<u8>(40, 0xbe);
+    octets[17]  = 0xff;
+    CHECK(potok::hpack::decode_indexed_run(octets, indices) == 17);
+  }
+
+  {
+    auto const octets = std::vector<u8>(40, 0x82);
+    CHECK(potok::hpack::decode_indexed_run(octets, potok::span<u8>(indices.data(), 20)) == 20);
+    CHECK(potok::hpack::decode_indexed_run(octets, indices) == 40);
+  }
+
+  {
+    auto const octets = std::vector<u8>();
+    CHECK(potok::hpack::decode_indexed_run(octets, indices) == 0);
+  }
+}
+
+TEST_CASE("Every variant of the run decoder should match the scalar one")
+{
+  auto rng = std::mt19937(1337);
+
+  for (unsigned i = 0; i < 2000; ++i) {
+    auto octets = std::vector<u8>(rng() % 100);
+    for (auto& octet : octets) {
+      // mostly matching octets with the occasional run breaker
+      //
+      octet = static_cast<u8>(rng() % 64 == 0 ? rng() : (0x81 + rng() % 126));
+    }
+
+    auto expected = std::vector<u8>(octets.size());
+    auto actual   = std::vector<u8>(octets.size());
+
+    auto const n_expected = potok::hpack::detail::decode_indexed_run_scalar(octets, expected);
+
+    auto const n_actual = potok::hpack::decode_indexed_run(octets, actual);
+    REQUIRE(n_expected == n_actual);
+    REQUIRE(std::equal(expected.begin(), expected.begin() + n_expected, actual.begin()));
+
+    for (auto level = potok::cpu_level::scalar; level <= potok::detect_cpu_level();
+         level      = static_cast<potok::cpu_level>(static_cast<u8>(level) + 1)) {
+      auto const n_variant = potok::hpack::make_kernels(level).decode_indexed_run(octets, actual);
+      REQUIRE(n_expected == n_variant);
+      REQUIRE(std::equal(expected.begin(), expected.begin() + n_expected, actual.begin()));
+    }
+  }
+}
@@ -3,9 +3,22 @@
 
 #include <potok/hpack/common.hpp>
 #include <potok/hpack/decode.hpp>
+#include <potok/hpack/encode.hpp>
+#include <potok/hpack/kernels.hpp>
+
+#include <potok/cpu.hpp>
+
+#include <potok/span.hpp>
 
 #include <boost/asio/buffer.hpp>
 
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <random>
+#include <tuple>
+#include <vector>
+
 using namespace potok::ints;
 
 TEST_CASE("C.1.1. Example 1: Encoding 10 Using a 5-Bit Prefix")
@@ -178,3 +191,328 @@ TEST_CASE("We should handle empty octet sequences correctly")
   CHECK(v == 0);
   CHECK(ec == potok::hpack::error::needs_more);
 }
+
+TEST_CASE("We should decode identically from a contiguous span and a segmented buffer sequence")
+{
+  auto const num_prefix_bits = 5;
+
+  auto const storage = std::vector<u8>{0b00011111, 0b10011010, 0b00001010};
+
+  {
+    auto d  = potok::hpack::integer_decoder(num_prefix_bits);
+    auto ec = boost::system::error_code();
+    auto v  = u64{0};
+
+    CHECK(3 == d(potok::span<u8 const>(storage.data(), storage.size()), v, ec));
+    CHECK(v == 1337);
+    CHECK(!ec);
+  }
+
+  {
+    auto d  = potok::hpack::integer_decoder(num_prefix_bits);
+    auto ec = boost::system::error_code();
+    auto v  = u64{0};
+
+    CHECK(3 == d(boost::asio::const_buffer(storage.data(), storage.size()), v, ec));
+    CHECK(v == 1337);
+    CHECK(!ec);
+  }
+
+  {
+    auto d  = potok::hpack::integer_decoder(num_prefix_bits);
+    auto ec = boost::system::error_code();
+    auto v  = u64{0};
+
+    auto const buf_seq = std::array<boost::asio::const_buffer, 3>{
+        boost::asio::const_buffer(storage.data(), 1),
+        boost::asio::const_buffer(storage.data() + 1, 1),
+        boost::asio::const_buffer(storage.data() + 2, 1),
+    };
+
+    CHECK(3 == d(buf_seq, v, ec));
+    CHECK(v == 1337);
+    CHECK(!ec);
+  }
+
+  {
+    auto d  = potok::hpack::integer_decoder(num_prefix_bits);
+    auto ec = boost::system::error_code();
+    auto v  = u64{0};
+
+    CHECK(2 == d(potok::span<u8 const>(storage.data(), 2), v, ec));
+    CHECK(v == 0);
+    REQUIRE(ec == potok::hpack::error::needs_more);
+
+    ec = {};
+
+    auto const buf_seq = std::array<boost::asio::const_buffer, 1>{boost::asio::const_buffer(storage.data() + 2, 1)};
+
+    CHECK(1 == d(buf_seq, v, ec));
+    CHECK(v == 1337);
+    CHECK(!ec);
+  }
+}
+
+namespace {
+
+// decodes `octets` twice, once through the contiguous fast path and once split across two segments, which
+// `integer_decoder` walks with a `buffer_cursor`, and checks that both agree
+//
+// the octets are padded so that the fast path is always taken, both paths see the same padding
+//
+auto decode_both_ways(u8 const              num_prefix_bits,    //
+                      std::vector<u8> const& octets,             //
+                      u64 const              max_value = std::numeric_limits<u64>::max())
+{
+  auto padded = octets;
+  padded.resize(octets.size() + potok::hpack::max_integer_octets, 0xff);
+
+  auto d1  = potok::hpack::integer_decoder(num_prefix_bits, max_value);
+  auto ec1 = boost::system::error_code();
+  auto v1  = u64{0};
+  auto n1  = d1(potok::span<u8 const>(padded.data(), padded.size()), v1, ec1);
+
+  auto const half    = octets.size() / 2;
+  auto const buf_seq = std::array<boost::asio::const_buffer, 2>{
+      boost::asio::const_buffer(padded.data(), half),
+      boost::asio::const_buffer(padded.data() + half, padded.size() - half),
+  };
+
+  auto d2  = potok::hpack::integer_decoder(num_prefix_bits, max_value);
+  auto ec2 = boost::system::error_code();
+  auto v2  = u64{0};
+  auto n2  = d2(buf_seq, v2, ec2);
+
+  CHECK(n1 == n2);
+  CHECK(v1 == v2);
+  CHECK(ec1 == ec2);
+
+  return std::make_tuple(n1, v1, ec1);
+}
+
+}    // namespace
+
+TEST_CASE("The unrolled fast path should agree with the resumable state machine")
+{
+  for (unsigned i = 0; i < 8; ++i) {
+    auto const num_prefix_bits = static_cast<u8>(1 + i);
+
+    auto values = std::vector<u64>{0, 1, 1337, std::numeric_limits<u64>::max()};
+    for (unsigned k = 0; k < 64; ++k) {
+      values.push_back((u64{1} << k) - 1);
+      values.push_back(u64{1} << k);
+      values.push_back((u64{1} << k) + 1);
+    }
+
+    for (auto const x : values) {
+      auto const size = potok::hpack::get_num_required_octets(x, num_prefix_bits);
+
+      auto octets = std::vector<u8>(size);
+      auto buf    = boost::asio::dynamic_vector_buffer(octets);
+      auto e      = potok::hpack::integer_encoder(x, num_prefix_bits);
+      auto ec     = boost::system::error_code();
+      REQUIRE(size == e(buf.data(0, buf.size()), ec));
+
+      auto const [n, v, dec_ec] = decode_both_ways(num_prefix_bits, octets);
+      REQUIRE(n == size);
+      REQUIRE(v == x);
+      REQUIRE(!dec_ec);
+    }
+  }
+}
+
+TEST_CASE("Both decoding paths should report overflow in the final continuation octet")
+{
+  auto const num_prefix_bits = 5;
+  auto const max             = potok::hpack::get_max_prefix_value(num_prefix_bits);
+
+  auto const octets = std::vector<u8>{max, ((255 - max) | 128), 255, 255, 255, 255, 255, 255, 255, 255, 2};
+
+  auto const [n, v, ec] = decode_both_ways(num_prefix_bits, octets);
+  CHECK(n == 11);
+  CHECK(v == 0);
+  CHECK(ec == potok::hpack::error::too_large);
+}
+
+TEST_CASE("Integers padded with empty continuation octets should decode up to the 11 octet limit")
+{
+  auto const num_prefix_bits = 5;
+
+  auto octets = std::vector<u8>{0b00011111, 0b10011010, 0b10001010};
+  octets.insert(octets.end(), 7, 0x80);
+  octets.push_back(0x00);
+  REQUIRE(octets.size() == potok::hpack::max_integer_octets);
+
+  {
+    auto const [n, v, ec] = decode_both_ways(num_prefix_bits, octets);
+    CHECK(n == octets.size());
+    CHECK(v == 1337);
+    CHECK(!ec);
+  }
+
+  octets.back() = 0x80;
+  octets.push_back(0x00);
+
+  {
+    auto const [n, v, ec] = decode_both_ways(num_prefix_bits, octets);
+    CHECK(n == 12);
+    CHECK(v == 0);
+    CHECK(ec == potok::hpack::error::too_large);
+  }
+}
+
+TEST_CASE("A caller-supplied maximum should reject larger values as early as possible")
+{
+  auto const num_prefix_bits = 5;
+  auto const max_value       = u64{4096};
+
+  {
+    auto const [n, v, ec] = decode_both_ways(num_prefix_bits, {0b00011111, 0b11100001, 0b00011111}, max_value);
+    CHECK(n == 3);
+    CHECK(v == 4096);
+    CHECK(!ec);
+  }
+
+  {
+    auto const [n, v, ec] = decode_both_ways(num_prefix_bits, {0b00011111, 0b11100010, 0b00011111}, max_value);
+    CHECK(n == 3);
+    CHECK(v == 0);
+    CHECK(ec == potok::hpack::error::limit_exceeded);
+  }
+
+  {
+    // 4096 again but padded out to one octet more than its shortest encoding
+    //
+    auto const [n, v, ec] =
+        decode_both_ways(num_prefix_bits, {0b00011111, 0b11100001, 0b10011111, 0b00000000}, max_value);
+    CHECK(n == 4);
+    CHECK(v == 0);
+    CHECK(ec == potok::hpack::error::limit_exceeded);
+  }
+
+  {
+    auto octets = std::vector<u8>{0b00011111};
+    octets.insert(octets.end(), 32, 0xff);
+
+    auto const [n, v, ec] = decode_both_ways(num_prefix_bits, octets, max_value);
+    CHECK(n == 3);
+    CHECK(v == 0);
+    CHECK(ec == potok::hpack::error::limit_exceeded);
+  }
+
+  {
+    auto const [n, v, ec] = decode_both_ways(num_prefix_bits, {0b00001011}, 10);
+    CHECK(n == 1);
+    CHECK(v == 0);
+    CHECK(ec == potok::hpack::error::limit_exceeded);
+  }
+}
+
+TEST_CASE("Both decoding paths should agree on arbitrary input")
+{
+  auto rng = std::mt19937(1337);
+
+  for (unsigned i = 0; i < 10000; ++i) {
+    auto const num_prefix_bits = static_cast<u8>(1 + rng() % 8);
+    auto const max_value       = (i % 2 == 0) ? std::numeric_limits<u64>::max() : u64{rng()};
+
+    auto octets = std::vector<u8>(1 + rng() % 14);
+    for (auto& octet : octets) {
+      // mostly continuation octets so that we exercise the longer encodings
+      //
+      octet = static_cast<u8>(rng());
+      if (rng() % 8 != 0) { octet |= 128; }
+    }
+    octets[0] |= static_cast<u8>(potok::hpack::get_max_prefix_value(num_prefix_bits));
+
+    decode_both_ways(num_prefix_bits, octets, max_value);
+  }
+}
+
+TEST_CASE("Every variant of the continuation kernel should match the scalar one")
+{
+  auto rng = std::mt19937(1337);
+
+  auto const scalar = potok::hpack::make_kernels(potok::cpu_level::scalar).decode_integer_continuation;
+
+  for (auto level = potok::cpu_level::scalar; level <= potok::detect_cpu_level();
+       level      = static_cast<potok::cpu_level>(static_cast<u8>(level) + 1)) {
+    auto const variant = potok::hpack::make_kernels(level).decode_integer_continuation;
+
+    for (unsigned i = 0; i < 10000; ++i) {
+      auto octets = std::array<u8, potok::hpack::max_integer_octets - 1>{};
+      for (auto& octet : octets) {
+        octet = static_cast<u8>(rng());
+        if (rng() % 6 != 0) { octet |= 128; }
+      }
+
+      auto const prefix = u64{rng() % 256};
+
+      auto       expected   = prefix;
+      auto       actual     = prefix;
+      auto const n_expected = scalar(octets.data(), expected);
+      auto const n_actual   = variant(octets.data(), actual);
+
+      REQUIRE(n_expected == n_actual);
+      if (n_expected != 0) { REQUIRE(expected == actual); }
+    }
+  }
+}
+
+#if POTOK_HAS_AVX2
+
+TEST_CASE("The BMI2 continuation kernel should match the scalar one even where pext is too slow to be picked")
+{
+  if (potok::detect_cpu_level() < potok::cpu_level::avx2) { return; }
+
+  auto rng = std::mt19937(1337);
+  for (unsigned i = 0; i < 10000; ++i) {
+    auto octets = std::array<u8, potok::hpack::max_integer_octets - 1>{};
+    for (auto& octet : octets) {
+      octet = static_cast<u8>(rng());
+      if (rng() % 6 != 0) { octet |= 128; }
+    }
+
+    auto const prefix = u64{rng() % 256};
+
+    auto       expected   = prefix;
+    auto       actual     = prefix;
+    auto const n_expected = potok::hpack::detail::decode_integer_continuation_scalar(octets.data(), expected);
+    auto const n_actual   = potok::hpack::detail::decode_integer_continuation_bmi2(octets.data(), actual);
+
+    REQUIRE(n_expected == n_actual);
+    if (n_expected != 0) { REQUIRE(expected == actual); }
+  }
+}
+
+#endif
+
+TEST_CASE("Forcing a CPU level should switch the decoders over and be capped at what the CPU supports")
+{
+  auto const detected = potok::detect_cpu_level();
+
+  for (auto level = potok::cpu_level::scalar; level <= potok::cpu_level::avx2;
+       level      = static_cast<potok::cpu_level>(static_cast<u8>(level) + 1)) {
+    auto const in_use = potok::hpack::force_cpu_level(level);
+    CHECK(in_use == std::min(level, detected));
+#if POTOK_HAS_AVX2
+    CHECK(potok::hpack::detail::use_pext == (in_use == potok::cpu_level::avx2 && potok::has_fast_pext()));
+#endif
+
+    auto rng = std::mt19937(1337);
+    for (unsigned i = 0; i < 1000; ++i) {
+      auto const num_prefix_bits = static_cast<u8>(1 + rng() % 8);
+
+      auto octets = std::vector<u8>(11 + rng() % 4);
+      for (auto& octet : octets) {
+        octet = static_cast<u8>(rng());
+        if (rng() % 8 != 0) { octet |= 128; }
+      }
+      octets[0] |= static_cast<u8>(potok::hpack::get_max_prefix_value(num_prefix_bits));
+
+      decode_both_ways(num_prefix_bits, octets);
+    }
+  }
+
+  potok::hpack::force_cpu_level(detected);
+}
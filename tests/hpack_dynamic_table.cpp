@@ -0,0 +1,159 @@
+#define CATCH_CONFIG_MAIN
+#include "catch_amalgamated.hpp"
+
+#include <potok/hpack/dynamic_table.hpp>
+#include <potok/hpack/header_field.hpp>
+
+#include <potok/bit.hpp>
+#include <potok/stdint.hpp>
+
+#include <deque>
+#include <random>
+#include <string>
+#include <utility>
+
+using namespace potok::ints;
+
+static_assert(potok::bit_ceil(0) == 1);
+static_assert(potok::bit_ceil(1) == 1);
+static_assert(potok::bit_ceil(3) == 4);
+static_assert(potok::bit_ceil(128) == 128);
+static_assert(potok::bit_ceil(129) == 256);
+
+namespace {
+
+// the table as the RFC describes it, one string per name and value
+//
+struct reference_table {
+  std::deque<std::pair<std::string, std::string>> entries;
+  usize                                            num_octets = 0;
+  usize                                            max_size   = 0;
+
+  auto evict_until(usize const size) -> void
+  {
+    while (num_octets > size) {
+      num_octets -= potok::hpack::entry_size(entries.back().first, entries.back().second);
+      entries.pop_back();
+    }
+  }
+
+  auto insert(std::string name, std::string value) -> void
+  {
+    auto const size = potok::hpack::entry_size(name, value);
+    if (size > max_size) {
+      evict_until(0);
+      return;
+    }
+
+    evict_until(max_size - size);
+    entries.emplace_front(std::move(name), std::move(value));
+    num_octets += size;
+  }
+};
+
+auto check_same(potok::hpack::dynamic_table const& table, reference_table const& ref) -> void
+{
+  REQUIRE(table.size() == ref.entries.size());
+  REQUIRE(table.num_octets() == ref.num_octets);
+  REQUIRE(table.max_size() == ref.max_size);
+
+  for (usize i = 0; i < table.size(); ++i) {
+    REQUIRE(table[i].name == ref.entries[i].first);
+    REQUIRE(table[i].value == ref.entries[i].second);
+  }
+}
+
+}    // namespace
+
+TEST_CASE("The dynamic table should evict the oldest entries first")
+{
+  auto table = potok::hpack::dynamic_table(100);
+
+  table.insert("a", "1");
+  table.insert("b", "22");
+  CHECK(table.size() == 2);
+  CHECK(table.num_octets() == 34 + 35);
+
+  // 69 + 36 > 100
+  //
+  table.insert("c", "333");
+  CHECK(table.size() == 2);
+  CHECK(table[0].name == "c");
+  CHECK(table[0].value == "333");
+  CHECK(table[1].name == "b");
+  CHECK(table[1].value == "22");
+
+  // larger than the whole table
+  //
+  table.insert("d", std::string(100, 'd'));
+  CHECK(table.size() == 0);
+  CHECK(table.num_octets() == 0);
+
+  table.set_max_size(0);
+  table.insert("e", "");
+  CHECK(table.size() == 0);
+}
+
+TEST_CASE("Names should survive being inserted from an entry that's about to be evicted")
+{
+  // https://datatracker.ietf.org/doc/html/rfc7541#section-4.4
+  //
+  auto table = potok::hpack::dynamic_table(120);
+  table.insert("x-name-to-reuse", "value");
+  table.insert("some-other-name", "12");
+  table.insert("yet-another-one", "3");
+
+  // the oldest entry is evicted to make room for a new one with its name
+  //
+  auto const oldest = table[table.size() - 1];
+  CHECK(oldest.name == "some-other-name");
+
+  table.insert(oldest.name, "a-longer-value");
+  CHECK(table[0].name == "some-other-name");
+  CHECK(table[0].value == "a-longer-value");
+  CHECK(table.size() == 2);
+}
+
+TEST_CASE("The dynamic table should match a straightforward implementation through wrap-arounds and resizes")
+{
+  auto rng = std::mt19937(1337);
+
+  for (usize const initial_size : {usize{0}, usize{64}, usize{256}, usize{4096}}) {
+    auto table = potok::hpack::dynamic_table(initial_size);
+    auto ref   = reference_table{};
+    ref.max_size = initial_size;
+
+    for (usize n = 0; n < 5000; ++n) {
+      auto const op = std::uniform_int_distribution<u32>(0, 99)(rng);
+      if (op < 3) {
+        auto const max_size = std::uniform_int_distribution<usize>(0, 2 * initial_size + 64)(rng);
+        table.set_max_size(max_size);
+        ref.max_size = max_size;
+        ref.evict_until(max_size);
+      }
+      else if (op < 30 && table.size() > 0) {
+        // reusing the name of an existing entry, as an indexed name would
+        //
+        auto const i    = std::uniform_int_distribution<usize>(0, table.size() - 1)(rng);
+        auto const name = std::string(table[i].name);
+        auto const len  = std::uniform_int_distribution<usize>(0, initial_size / 2 + 8)(rng);
+
+        table.insert(table[i].name, std::string(len, static_cast<char>('a' + n % 26)));
+        ref.insert(name, std::string(len, static_cast<char>('a' + n % 26)));
+      }
+      else {
+        auto const name_len  = std::uniform_int_distribution<usize>(0, 40)(rng);
+        auto const value_len = std::uniform_int_distribution<usize>(0, initial_size / 2 + 8)(rng);
+
+        auto name  = std::string(name_len, static_cast<char>('A' + n % 26));
+        auto value = std::string(value_len, static_cast<char>('0' + n % 10));
+        if (!name.empty()) { name.back() = static_cast<char>(n); }
+
+        table.insert(name, value);
+        ref.insert(std::move(name), std::move(value));
+      }
+
+      check_same(table, ref);
+    }
+  }
+}
@@ -6,12 +6,29 @@
 
 #include <boost/system/error_code.hpp>
 
+#include <array>
 #include <limits>
 #include <vector>
 
 using potok::u64;
 using potok::u8;
 
+namespace {
+
+constexpr auto const encoded_10   = potok::hpack::make_encoded_integer<10, 5>();
+constexpr auto const encoded_1337 = potok::hpack::make_encoded_integer<1337, 5>();
+constexpr auto const encoded_42   = potok::hpack::make_encoded_integer<42, 8>();
+constexpr auto const indexed_8    = potok::hpack::make_encoded_integer<8, 7, 0x80>();
+
+static_assert(encoded_10.size() == 1 && encoded_10[0] == 0b00001010);
+static_assert(encoded_1337.size() == 3 && encoded_1337[0] == 0b00011111 && encoded_1337[1] == 0b10011010 &&
+              encoded_1337[2] == 0b00001010);
+static_assert(encoded_42.size() == 1 && encoded_42[0] == 0b00101010);
+static_assert(indexed_8.size() == 1 && indexed_8[0] == 0x88);
+static_assert(potok::hpack::make_encoded_integer<std::numeric_limits<u64>::max(), 1>().size() == 11);
+
+}    // namespace
+
 TEST_CASE("C.1.1. Example 1: Encoding 10 Using a 5-Bit Prefix")
 {
   // https://datatracker.ietf.org/doc/html/rfc7541#appendix-C.1.1
@@ -357,3 +374,94 @@ TEST_CASE("We should be able to encode multiple integers in a row, using the sam
     CHECK(storage[i] == expected[i]);
   }
 }
+
+TEST_CASE("encode_integer should write the RFC examples in a single pass")
+{
+  {
+    auto storage = std::vector<u8>(potok::hpack::get_num_required_octets(10, 5));
+    auto end     = potok::hpack::encode_integer(10, 5, storage);
+    REQUIRE(end == storage.data() + storage.size());
+    REQUIRE(storage == std::vector<u8>{0b00001010});
+  }
+
+  {
+    auto storage = std::vector<u8>(potok::hpack::get_num_required_octets(1337, 5));
+    auto end     = potok::hpack::encode_integer(1337, 5, storage);
+    REQUIRE(end == storage.data() + storage.size());
+    REQUIRE(storage == std::vector<u8>{0b00011111, 0b10011010, 0b00001010});
+  }
+
+  {
+    auto storage = std::vector<u8>(potok::hpack::get_num_required_octets(42, 8));
+    auto end     = potok::hpack::encode_integer(42, 8, storage);
+    REQUIRE(end == storage.data() + storage.size());
+    REQUIRE(storage == std::vector<u8>{0b00101010});
+  }
+}
+
+TEST_CASE("encode_integer should produce the same octets as integer_encoder")
+{
+  for (unsigned i = 0; i < 8; ++i) {
+    auto const num_prefix_bits = static_cast<u8>(1 + i);
+
+    for (unsigned k = 0; k < 64; ++k) {
+      for (auto const x : {(u64{1} << k) - 1, u64{1} << k, std::numeric_limits<u64>::max() >> k}) {
+        auto const size = potok::hpack::get_num_required_octets(x, num_prefix_bits);
+
+        auto expected = std::vector<u8>(size, 0xff);
+        auto buf      = boost::asio::dynamic_vector_buffer(expected);
+        auto e        = potok::hpack::integer_encoder(x, num_prefix_bits);
+        auto ec       = boost::system::error_code();
+        REQUIRE(size == e(buf.data(0, buf.size()), ec));
+
+        auto actual = std::vector<u8>(size, 0xff);
+        auto end    = potok::hpack::encode_integer(x, num_prefix_bits, actual);
+
+        REQUIRE(end == actual.data() + actual.size());
+        REQUIRE(actual == expected);
+      }
+    }
+  }
+}
+
+TEST_CASE("make_encoded_integer should match integer_encoder at compile-time")
+{
+  auto check = [](auto const& octets, u64 const x, u8 const num_prefix_bits, u8 const flags) {
+    auto expected = std::vector<u8>(potok::hpack::get_num_required_octets(x, num_prefix_bits));
+    expected[0]   = flags;
+
+    auto buf = boost::asio::dynamic_vector_buffer(expected);
+    auto e   = potok::hpack::integer_encoder(x, num_prefix_bits);
+    auto ec  = boost::system::error_code();
+    REQUIRE(expected.size() == e(buf.data(0, buf.size()), ec));
+
+    REQUIRE(std::vector<u8>(octets.begin(), octets.end()) == expected);
+  };
+
+  static constexpr auto const indexed_status_200 = potok::hpack::make_encoded_integer<8, 7, 0x80>();
+  static constexpr auto const content_length     = potok::hpack::make_encoded_integer<1048576, 4>();
+  static constexpr auto const u64_max = potok::hpack::make_encoded_integer<std::numeric_limits<u64>::max(), 3, 0xa0>();
+
+  check(indexed_status_200, 8, 7, 0x80);
+  check(content_length, 1048576, 4, 0x00);
+  check(u64_max, std::numeric_limits<u64>::max(), 3, 0xa0);
+}
+
+TEST_CASE("Encoding should continue across the segments of a MutableBufferSequence")
+{
+  auto storage = std::vector<u8>(3);
+
+  auto const buf_seq = std::array<boost::asio::mutable_buffer, 4>{
+      boost::asio::mutable_buffer(storage.data(), 1),
+      boost::asio::mutable_buffer(storage.data() + 1, 0),
+      boost::asio::mutable_buffer(storage.data() + 1, 1),
+      boost::asio::mutable_buffer(storage.data() + 2, 1),
+  };
+
+  auto e  = potok::hpack::integer_encoder(1337, 5);
+  auto ec = boost::system::error_code();
+
+  REQUIRE(3 == e(buf_seq, ec));
+  REQUIRE(!ec);
+  REQUIRE(storage == std::vector<u8>{0b00011111, 0b10011010, 0b00001010});
+}
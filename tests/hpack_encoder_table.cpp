@@ -0,0 +1,93 @@
+#define CATCH_CONFIG_MAIN
+#include "catch_amalgamated.hpp"
+
+#include <potok/hpack/encoder_table.hpp>
+#include <potok/hpack/static_table.hpp>
+
+#include <potok/stdint.hpp>
+
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace potok::ints;
+
+namespace {
+
+// the scan the hash indices stand in for
+//
+auto linear_find(potok::hpack::dynamic_table const& table, std::string_view const name, std::string_view const value)
+    -> potok::hpack::table_match
+{
+  auto match = potok::hpack::table_match{};
+  for (usize i = 0; i < table.size(); ++i) {
+    if (table[i].name != name) { continue; }
+
+    if (table[i].value == value) { return {potok::hpack::static_table_size + 1 + i, true}; }
+    if (match.index == 0) { match.index = potok::hpack::static_table_size + 1 + i; }
+  }
+  return match;
+}
+
+}    // namespace
+
+TEST_CASE("The encoder's indices should find the same entries as a linear scan")
+{
+  auto rng = std::mt19937(1337);
+
+  auto const names  = std::vector<std::string>{"", "a", "x-request-id", "content-type", "set-cookie", "server",
+                                              "x-a-name-longer-than-a-word"};
+  auto const values = std::vector<std::string>{"", "1", "2", "text/html", "nginx", "a-value-longer-than-a-word",
+                                               std::string(200, 'v')};
+
+  auto pick = [&](auto const& v) -> auto const& {
+    return v[std::uniform_int_distribution<usize>(0, v.size() - 1)(rng)];
+  };
+
+  for (usize const initial_size : {usize{0}, usize{32}, usize{256}, usize{4096}}) {
+    auto table = potok::hpack::encoder_table(initial_size);
+
+    for (usize n = 0; n < 20000; ++n) {
+      auto const op = std::uniform_int_distribution<u32>(0, 99)(rng);
+      if (op < 2) {
+        table.set_max_size(std::uniform_int_distribution<usize>(0, 2 * initial_size + 64)(rng));
+      }
+      else if (op < 10 && table.table().size() > 0) {
+        // an indexed name, possibly that of the entry about to be evicted
+        //
+        auto const i = std::uniform_int_distribution<usize>(0, table.table().size() - 1)(rng);
+        table.insert(table.table()[i].name, pick(values));
+      }
+      else if (op < 50) {
+        table.insert(pick(names), pick(values));
+      }
+
+      auto const& name  = pick(names);
+      auto const& value = pick(values);
+
+      auto const expected = linear_find(table.table(), name, value);
+      auto const actual   = table.find(name, value);
+      REQUIRE(actual.index == expected.index);
+      REQUIRE(actual.full == expected.full);
+    }
+  }
+}
+
+TEST_CASE("A table full of the smallest possible entries should stay findable")
+{
+  // 128 entries of exactly 32 octets each, which fills the ring of hashes to the brim
+  //
+  auto table = potok::hpack::encoder_table(4096);
+  for (usize n = 0; n < 1000; ++n) {
+    table.insert("", "");
+    REQUIRE(table.table().size() == std::min(n + 1, usize{128}));
+    REQUIRE(table.find("", "").index == potok::hpack::static_table_size + 1);
+  }
+
+  table.insert("x", "y");
+  CHECK(table.find("x", "y").index == potok::hpack::static_table_size + 1);
+  CHECK(table.find("", "").index == potok::hpack::static_table_size + 2);
+  CHECK(table.find("x", "z").index == potok::hpack::static_table_size + 1);
+  CHECK(!table.find("x", "z").full);
+  CHECK(table.find("y", "").index == 0);
+}
@@ -0,0 +1,76 @@
+#define CATCH_CONFIG_MAIN
+#include "catch_amalgamated.hpp"
+
+#include <potok/hpack/decode.hpp>
+#include <potok/hpack/representation.hpp>
+
+#include <potok/span.hpp>
+#include <potok/stdint.hpp>
+
+#include <vector>
+
+using namespace potok::ints;
+using potok::hpack::representation;
+
+static_assert(potok::hpack::classify_field(0x82).kind == representation::indexed);
+static_assert(potok::hpack::classify_field(0x82).value == 2);
+static_assert(potok::hpack::classify_field(0x41).kind == representation::incremental_indexing);
+static_assert(potok::hpack::classify_field(0x41).value == 1);
+static_assert(potok::hpack::classify_field(0x3f).kind == representation::size_update);
+static_assert(potok::hpack::classify_field(0x3f).has_continuation);
+
+TEST_CASE("The first octet table should agree with the bit patterns from the RFC")
+{
+  for (unsigned i = 0; i < 256; ++i) {
+    auto const octet  = static_cast<u8>(i);
+    auto const prefix = potok::hpack::classify_field(octet);
+
+    auto expected_kind            = representation::without_indexing;
+    auto expected_num_prefix_bits = 4;
+
+    if ((octet & 0b1000'0000) == 0b1000'0000) {
+      expected_kind            = representation::indexed;
+      expected_num_prefix_bits = 7;
+    }
+    else if ((octet & 0b1100'0000) == 0b0100'0000) {
+      expected_kind            = representation::incremental_indexing;
+      expected_num_prefix_bits = 6;
+    }
+    else if ((octet & 0b1110'0000) == 0b0010'0000) {
+      expected_kind            = representation::size_update;
+      expected_num_prefix_bits = 5;
+    }
+    else if ((octet & 0b1111'0000) == 0b0001'0000) {
+      expected_kind            = representation::never_indexed;
+      expected_num_prefix_bits = 4;
+    }
+
+    auto const max_prefix_value = potok::hpack::get_max_prefix_value(expected_num_prefix_bits);
+
+    REQUIRE(prefix.kind == expected_kind);
+    REQUIRE(prefix.num_prefix_bits == expected_num_prefix_bits);
+    REQUIRE(prefix.value == (octet & max_prefix_value));
+    REQUIRE(prefix.has_continuation == ((octet & max_prefix_value) == max_prefix_value));
+  }
+}
+
+TEST_CASE("A field prefix with continuation octets should feed into integer_decoder")
+{
+  // literal header field with incremental indexing, name index 1337
+  //
+  auto const octets = std::vector<u8>{0b0111'1111, 0b1111'1010, 0b0000'1001};
+
+  auto const prefix = potok::hpack::classify_field(octets[0]);
+  REQUIRE(prefix.kind == representation::incremental_indexing);
+  REQUIRE(prefix.has_continuation);
+
+  auto d = potok::hpack::integer_decoder(prefix.num_prefix_bits);
+  d.skip_prefix();
+
+  auto ec = boost::system::error_code();
+  auto v  = u64{0};
+
+  CHECK(2 == d(potok::span<u8 const>(octets.data() + 1, octets.size() - 1), v, ec));
+  CHECK(v == 1337);
+  CHECK(!ec);
+}
@@ -0,0 +1,104 @@
+#define CATCH_CONFIG_MAIN
+#include "catch_amalgamated.hpp"
+
+#include <potok/hpack/static_table.hpp>
+
+#include <potok/stdint.hpp>
+
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace potok::ints;
+
+namespace {
+
+// the scan the perfect hash stands in for
+//
+auto linear_find(std::string_view const name, std::string_view const value) -> potok::hpack::table_match
+{
+  auto match = potok::hpack::table_match{};
+  for (usize i = 0; i < potok::hpack::static_table.size(); ++i) {
+    auto const& entry = potok::hpack::static_table[i];
+    if (entry.name != name) { continue; }
+
+    if (entry.value == value) { return {i + 1, true}; }
+    if (match.index == 0) { match.index = i + 1; }
+  }
+  return match;
+}
+
+}    // namespace
+
+TEST_CASE("Every entry of the static table should be found at its own index")
+{
+  for (usize i = 0; i < potok::hpack::static_table.size(); ++i) {
+    auto const& entry = potok::hpack::static_table[i];
+
+    auto const match = potok::hpack::find_static(entry.name, entry.value);
+    CHECK(match.index == i + 1);
+    CHECK(match.full);
+
+    auto const name_match = potok::hpack::find_static(entry.name, "not a value in the table");
+    CHECK(name_match.index == linear_find(entry.name, "not a value in the table").index);
+    CHECK(!name_match.full);
+  }
+
+  CHECK(potok::hpack::find_static(":status", "404").index == 13);
+  CHECK(potok::hpack::find_static(":status", "418").index == 8);
+  CHECK(potok::hpack::find_static(":path", "").index == 4);
+  CHECK(potok::hpack::find_static("www-authenticate", "Basic").index == 61);
+}
+
+TEST_CASE("Names that aren't in the static table should be missed")
+{
+  CHECK(potok::hpack::find_static("", "").index == 0);
+  CHECK(potok::hpack::find_static(":method2", "GET").index == 0);
+  CHECK(potok::hpack::find_static(":METHOD", "GET").index == 0);
+  CHECK(potok::hpack::find_static("Content-Type", "").index == 0);
+  CHECK(potok::hpack::find_static("x-content-type-options", "nosniff").index == 0);
+  CHECK(potok::hpack::find_static(std::string(300, 'a'), "").index == 0);
+
+  // same length, first, middle and last character as "if-match", i.e. the same key
+  //
+  CHECK(potok::hpack::find_static("i---a--h", "").index == 0);
+}
+
+TEST_CASE("The static table lookup should agree with a linear scan")
+{
+  auto rng = std::mt19937(1337);
+
+  auto names = std::vector<std::string>();
+  for (auto const& entry : potok::hpack::static_table) { names.emplace_back(entry.name); }
+
+  auto const values = std::vector<std::string>{"", "GET", "POST", "/", "/index.html", "http", "https", "200",
+                                               "204", "206", "304", "400", "404", "500", "gzip, deflate", "x"};
+
+  for (usize n = 0; n < 100000; ++n) {
+    auto name = names[std::uniform_int_distribution<usize>(0, names.size() - 1)(rng)];
+
+    // most names are mangled a little, which keeps most lookups close to an actual entry
+    //
+    switch (std::uniform_int_distribution<u32>(0, 4)(rng)) {
+      case 0:
+        name[std::uniform_int_distribution<usize>(0, name.size() - 1)(rng)] =
+            static_cast<char>(std::uniform_int_distribution<int>(0x20, 0x7e)(rng));
+        break;
+      case 1:
+        name.pop_back();
+        break;
+      case 2:
+        name.push_back(static_cast<char>(std::uniform_int_distribution<int>(0x20, 0x7e)(rng)));
+        break;
+      default:
+        break;
+    }
+
+    auto const& value = values[std::uniform_int_distribution<usize>(0, values.size() - 1)(rng)];
+
+    auto const expected = linear_find(name, value);
+    auto const actual   = potok::hpack::find_static(name, value);
+    REQUIRE(actual.index == expected.index);
+    REQUIRE(actual.full == expected.full);
+  }
+}
@@ -1,113 +1,24 @@
 #define CATCH_CONFIG_MAIN
 #include "catch_amalgamated.hpp"
 
+#include <potok/hpack/error.hpp>
+#include <potok/hpack/huffman.hpp>
+#include <potok/hpack/huffman_code.hpp>
+
 #include <potok/span.hpp>
 #include <potok/stdint.hpp>
 
+#include <boost/asio/buffer.hpp>
 #include <boost/assert.hpp>
 
+#include <algorithm>
 #include <memory_resource>
 #include <optional>
+#include <random>
+#include <string>
+#include <string_view>
 #include <vector>
 
-namespace potok {
-namespace huffman {
-
-// u32 const codewords[257] = {
-//     0x1ff8,     0x7fffd8,  0xfffffe2,  0xfffffe3,  0xfffffe4, 0xfffffe5, 0xfffffe6, 0xfffffe7, 0xfffffe8, 0xffffea,
-//     0x3ffffffc, 0xfffffe9, 0xfffffea,  0x3ffffffd, 0xfffffeb, 0xfffffec, 0xfffffed, 0xfffffee, 0xfffffef, 0xffffff0,
-//     0xffffff1,  0xffffff2, 0x3ffffffe, 0xffffff3,  0xffffff4, 0xffffff5, 0xffffff6, 0xffffff7, 0xffffff8, 0xffffff9,
-//     0xffffffa,  0xffffffb, 0x14,       0x3f8,      0x3f9,     0xffa,     0x1ff9,    0x15,      0xf8,      0x7fa,
-//     0x3fa,      0x3fb,     0xf9,       0x7fb,      0xfa,      0x16,      0x17,      0x18,      0x0,       0x1,
-//     0x2,        0x19,      0x1a,       0x1b,       0x1c,      0x1d,      0x1e,      0x1f,      0x5c,      0xfb,
-//     0x7ffc,     0x20,      0xffb,      0x3fc,      0x1ffa,    0x21,      0x5d,      0x5e,      0x5f,      0x60,
-//     0x61,       0x62,      0x63,       0x64,       0x65,      0x66,      0x67,      0x68,      0x69,      0x6a,
-//     0x6b,       0x6c,      0x6d,       0x6e,       0x6f,      0x70,      0x71,      0x72,      0xfc,      0x73,
-//     0xfd,       0x1ffb,    0x7fff0,    0x1ffc,     0x3ffc,    0x22,      0x7ffd,    0x3,       0x23,      0x4,
-//     0x24,       0x5,       0x25,       0x26,       0x27,      0x6,       0x74,      0x75,      0x28,      0x29,
-//     0x2a,       0x7,       0x2b,       0x76,       0x2c,      0x8,       0x9,       0x2d,      0x77,      0x78,
-//     0x79,       0x7a,      0x7b,       0x7ffe,     0x7fc,     0x3ffd,    0x1ffd,    0xffffffc, 0xfffe6,   0x3fffd2,
-//     0xfffe7,    0xfffe8,   0x3fffd3,   0x3fffd4,   0x3fffd5,  0x7fffd9,  0x3fffd6,  0x7fffda,  0x7fffdb,  0x7fffdc,
-//     0x7fffdd,   0x7fffde,  0xffffeb,   0x7fffdf,   0xffffec,  0xffffed,  0x3fffd7,  0x7fffe0,  0xffffee,  0x7fffe1,
-//     0x7fffe2,   0x7fffe3,  0x7fffe4,   0x1fffdc,   0x3fffd8,  0x7fffe5,  0x3fffd9,  0x7fffe6,  0x7fffe7,  0xffffef,
-//     0x3fffda,   0x1fffdd,  0xfffe9,    0x3fffdb,   0x3fffdc,  0x7fffe8,  0x7fffe9,  0x1fffde,  0x7fffea,  0x3fffdd,
-//     0x3fffde,   0xfffff0,  0x1fffdf,   0x3fffdf,   0x7fffeb,  0x7fffec,  0x1fffe0,  0x1fffe1,  0x3fffe0,  0x1fffe2,
-//     0x7fffed,   0x3fffe1,  0x7fffee,   0x7fffef,   0xfffea,   0x3fffe2,  0x3fffe3,  0x3fffe4,  0x7ffff0,  0x3fffe5,
-//     0x3fffe6,   0x7ffff1,  0x3ffffe0,  0x3ffffe1,  0xfffeb,   0x7fff1,   0x3fffe7,  0x7ffff2,  0x3fffe8,  0x1ffffec,
-//     0x3ffffe2,  0x3ffffe3, 0x3ffffe4,  0x7ffffde,  0x7ffffdf, 0x3ffffe5, 0xfffff1,  0x1ffffed, 0x7fff2,   0x1fffe3,
-//     0x3ffffe6,  0x7ffffe0, 0x7ffffe1,  0x3ffffe7,  0x7ffffe2, 0xfffff2,  0x1fffe4,  0x1fffe5,  0x3ffffe8, 0x3ffffe9,
-//     0xffffffd,  0x7ffffe3, 0x7ffffe4,  0x7ffffe5,  0xfffec,   0xfffff3,  0xfffed,   0x1fffe6,  0x3fffe9,  0x1fffe7,
-//     0x1fffe8,   0x7ffff3,  0x3fffea,   0x3fffeb,   0x1ffffee, 0x1ffffef, 0xfffff4,  0xfffff5,  0x3ffffea, 0x7ffff4,
-//     0x3ffffeb,  0x7ffffe6, 0x3ffffec,  0x3ffffed,  0x7ffffe7, 0x7ffffe8, 0x7ffffe9, 0x7ffffea, 0x7ffffeb, 0xffffffe,
-//     0x7ffffec,  0x7ffffed, 0x7ffffee,  0x7ffffef,  0x7fffff0, 0x3ffffee, 0x3fffffff};
-
-// u32 const bit_lens[257] = {
-//     13, 23, 28, 28, 28, 28, 28, 28, 28, 24, 30, 28, 28, 30, 28, 28, 28, 28, 28, 28, 28, 28, 30, 28, 28, 28, 28, 28,
-//     28, 28, 28, 28, 6,  10, 10, 12, 13, 6,  8,  11, 10, 10, 8,  11, 8,  6,  6,  6,  5,  5,  5,  6,  6,  6,  6,  6, 6,
-//     6, 7,  8,  15, 6,  12, 10, 13, 6,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,  7,
-//     7, 7,  8,  7,  8,  13, 19, 13, 14, 6,  15, 5,  6,  5,  6,  5,  6,  6,  6,  5,  7,  7,  6,  6,  6,  5,  6,  7,  6,
-//     5, 5,  6,  7,  7,  7,  7,  7,  15, 11, 14, 13, 28, 20, 22, 20, 20, 22, 22, 22, 23, 22, 23, 23, 23, 23, 23, 24,
-//     23, 24, 24, 22, 23, 24, 23, 23, 23, 23, 21, 22, 23, 22, 23, 23, 24, 22, 21, 20, 22, 22, 23, 23, 21, 23, 22, 22,
-//     24, 21, 22, 23, 23, 21, 21, 22, 21, 23, 22, 23, 23, 20, 22, 22, 22, 23, 22, 22, 23, 26, 26, 20, 19, 22, 23, 22,
-//     25, 26, 26, 26, 27, 27, 26, 24, 25, 19, 21, 26, 27, 27, 26, 27, 24, 21, 21, 26, 26, 28, 27, 27, 27, 20, 24, 20,
-//     21, 22, 21, 21, 23, 22, 22, 25, 25, 24, 24, 26, 23, 26, 27, 26, 26, 27, 27, 27, 27, 27, 28, 27, 27, 27, 27, 27,
-//     26, 30,
-// };
-
-// u32 const table[257][2] = {
-//     {0x1ff8, 13},    {0x7fffd8, 23},   {0xfffffe2, 28}, {0xfffffe3, 28}, {0xfffffe4, 28},  {0xfffffe5, 28},
-//     {0xfffffe6, 28}, {0xfffffe7, 28},  {0xfffffe8, 28}, {0xffffea, 24},  {0x3ffffffc, 30}, {0xfffffe9, 28},
-//     {0xfffffea, 28}, {0x3ffffffd, 30}, {0xfffffeb, 28}, {0xfffffec, 28}, {0xfffffed, 28},  {0xfffffee, 28},
-//     {0xfffffef, 28}, {0xffffff0, 28},  {0xffffff1, 28}, {0xffffff2, 28}, {0x3ffffffe, 30}, {0xffffff3, 28},
-//     {0xffffff4, 28}, {0xffffff5, 28},  {0xffffff6, 28}, {0xffffff7, 28}, {0xffffff8, 28},  {0xffffff9, 28},
-//     {0xffffffa, 28}, {0xffffffb, 28},  {0x14, 6},       {0x3f8, 10},     {0x3f9, 10},      {0xffa, 12},
-//     {0x1ff9, 13},    {0x15, 6},        {0xf8, 8},       {0x7fa, 11},     {0x3fa, 10},      {0x3fb, 10},
-//     {0xf9, 8},       {0x7fb, 11},      {0xfa, 8},       {0x16, 6},       {0x17, 6},        {0x18, 6},
-//     {0x0, 5},        {0x1, 5},         {0x2, 5},        {0x19, 6},       {0x1a, 6},        {0x1b, 6},
-//     {0x1c, 6},       {0x1d, 6},        {0x1e, 6},       {0x1f, 6},       {0x5c, 7},        {0xfb, 8},
-//     {0x7ffc, 15},    {0x20, 6},        {0xffb, 12},     {0x3fc, 10},     {0x1ffa, 13},     {0x21, 6},
-//     {0x5d, 7},       {0x5e, 7},        {0x5f, 7},       {0x60, 7},       {0x61, 7},        {0x62, 7},
-//     {0x63, 7},       {0x64, 7},        {0x65, 7},       {0x66, 7},       {0x67, 7},        {0x68, 7},
-//     {0x69, 7},       {0x6a, 7},        {0x6b, 7},       {0x6c, 7},       {0x6d, 7},        {0x6e, 7},
-//     {0x6f, 7},       {0x70, 7},        {0x71, 7},       {0x72, 7},       {0xfc, 8},        {0x73, 7},
-//     {0xfd, 8},       {0x1ffb, 13},     {0x7fff0, 19},   {0x1ffc, 13},    {0x3ffc, 14},     {0x22, 6},
-//     {0x7ffd, 15},    {0x3, 5},         {0x23, 6},       {0x4, 5},        {0x24, 6},        {0x5, 5},
-//     {0x25, 6},       {0x26, 6},        {0x27, 6},       {0x6, 5},        {0x74, 7},        {0x75, 7},
-//     {0x28, 6},       {0x29, 6},        {0x2a, 6},       {0x7, 5},        {0x2b, 6},        {0x76, 7},
-//     {0x2c, 6},       {0x8, 5},         {0x9, 5},        {0x2d, 6},       {0x77, 7},        {0x78, 7},
-//     {0x79, 7},       {0x7a, 7},        {0x7b, 7},       {0x7ffe, 15},    {0x7fc, 11},      {0x3ffd, 14},
-//     {0x1ffd, 13},    {0xffffffc, 28},  {0xfffe6, 20},   {0x3fffd2, 22},  {0xfffe7, 20},    {0xfffe8, 20},
-//     {0x3fffd3, 22},  {0x3fffd4, 22},   {0x3fffd5, 22},  {0x7fffd9, 23},  {0x3fffd6, 22},   {0x7fffda, 23},
-//     {0x7fffdb, 23},  {0x7fffdc, 23},   {0x7fffdd, 23},  {0x7fffde, 23},  {0xffffeb, 24},   {0x7fffdf, 23},
-//     {0xffffec, 24},  {0xffffed, 24},   {0x3fffd7, 22},  {0x7fffe0, 23},  {0xffffee, 24},   {0x7fffe1, 23},
-//     {0x7fffe2, 23},  {0x7fffe3, 23},   {0x7fffe4, 23},  {0x1fffdc, 21},  {0x3fffd8, 22},   {0x7fffe5, 23},
-//     {0x3fffd9, 22},  {0x7fffe6, 23},   {0x7fffe7, 23},  {0xffffef, 24},  {0x3fffda, 22},   {0x1fffdd, 21},
-//     {0xfffe9, 20},   {0x3fffdb, 22},   {0x3fffdc, 22},  {0x7fffe8, 23},  {0x7fffe9, 23},   {0x1fffde, 21},
-//     {0x7fffea, 23},  {0x3fffdd, 22},   {0x3fffde, 22},  {0xfffff0, 24},  {0x1fffdf, 21},   {0x3fffdf, 22},
-//     {0x7fffeb, 23},  {0x7fffec, 23},   {0x1fffe0, 21},  {0x1fffe1, 21},  {0x3fffe0, 22},   {0x1fffe2, 21},
-//     {0x7fffed, 23},  {0x3fffe1, 22},   {0x7fffee, 23},  {0x7fffef, 23},  {0xfffea, 20},    {0x3fffe2, 22},
-//     {0x3fffe3, 22},  {0x3fffe4, 22},   {0x7ffff0, 23},  {0x3fffe5, 22},  {0x3fffe6, 22},   {0x7ffff1, 23},
-//     {0x3ffffe0, 26}, {0x3ffffe1, 26},  {0xfffeb, 20},   {0x7fff1, 19},   {0x3fffe7, 22},   {0x7ffff2, 23},
-//     {0x3fffe8, 22},  {0x1ffffec, 25},  {0x3ffffe2, 26}, {0x3ffffe3, 26}, {0x3ffffe4, 26},  {0x7ffffde, 27},
-//     {0x7ffffdf, 27}, {0x3ffffe5, 26},  {0xfffff1, 24},  {0x1ffffed, 25}, {0x7fff2, 19},    {0x1fffe3, 21},
-//     {0x3ffffe6, 26}, {0x7ffffe0, 27},  {0x7ffffe1, 27}, {0x3ffffe7, 26}, {0x7ffffe2, 27},  {0xfffff2, 24},
-//     {0x1fffe4, 21},  {0x1fffe5, 21},   {0x3ffffe8, 26}, {0x3ffffe9, 26}, {0xffffffd, 28},  {0x7ffffe3, 27},
-//     {0x7ffffe4, 27}, {0x7ffffe5, 27},  {0xfffec, 20},   {0xfffff3, 24},  {0xfffed, 20},    {0x1fffe6, 21},
-//     {0x3fffe9, 22},  {0x1fffe7, 21},   {0x1fffe8, 21},  {0x7ffff3, 23},  {0x3fffea, 22},   {0x3fffeb, 22},
-//     {0x1ffffee, 25}, {0x1ffffef, 25},  {0xfffff4, 24},  {0xfffff5, 24},  {0x3ffffea, 26},  {0x7ffff4, 23},
-//     {0x3ffffeb, 26}, {0x7ffffe6, 27},  {0x3ffffec, 26}, {0x3ffffed, 26}, {0x7ffffe7, 27},  {0x7ffffe8, 27},
-//     {0x7ffffe9, 27}, {0x7ffffea, 27},  {0x7ffffeb, 27}, {0xffffffe, 28}, {0x7ffffec, 27},  {0x7ffffed, 27},
-//     {0x7ffffee, 27}, {0x7ffffef, 27},  {0x7fffff0, 27}, {0x3ffffee, 26}, {0x3fffffff, 30},
-// };
-
-// struct decoder {
-//   std::pmr::vector<u32> codewords_;
-//   std::pmr::vector<u32> bit_lens_;
-// };
-
-}    // namespace huffman
-}    // namespace potok
-
 using namespace potok::ints;
 
 auto codeword_match(u32 const* codewords, u32 const* masks, usize const len, u32 const v) -> std::optional<usize>
@@ -201,3 +112,560 @@ TEST_CASE("Codeword matching!")
     REQUIRE(!maybe_idx);
   }
 }
+
+namespace {
+
+// a naive bit-at-a-time encoder, independent of the library's own encoder
+//
+auto reference_encode(std::vector<u32> const& syms) -> std::vector<u8>
+{
+  auto out = std::vector<u8>();
+
+  auto acc      = u64{0};
+  auto num_bits = u32{0};
+  for (auto const sym : syms) {
+    auto const code    = potok::hpack::huffman_codes[sym].code;
+    auto const bit_len = u32{potok::hpack::huffman_codes[sym].bit_len};
+    for (u32 i = bit_len; i > 0; --i) {
+      acc = (acc << 1) | ((code >> (i - 1)) & 1);
+      if (++num_bits == 8) {
+        out.push_back(static_cast<u8>(acc));
+        acc      = 0;
+        num_bits = 0;
+      }
+    }
+  }
+
+  if (num_bits > 0) { out.push_back(static_cast<u8>((acc << (8 - num_bits)) | (0xff >> num_bits))); }
+  return out;
+}
+
+auto decode(std::vector<u8> const&             encoded,    //
+            boost::system::error_code&         ec,         //
+            potok::hpack::huffman_lookup const lookup) -> std::string
+{
+  auto out = std::string(potok::hpack::huffman_max_decoded_size(encoded.size()), '\0');
+  auto n   = potok::hpack::decode_huffman(
+      encoded, potok::span<u8>(reinterpret_cast<u8*>(out.data()), out.size()), ec, lookup);
+  out.resize(n);
+  return out;
+}
+
+// decodes with every table layout, checking that they all agree
+//
+auto decode(std::vector<u8> const& encoded, boost::system::error_code& ec) -> std::string
+{
+  auto const single = decode(encoded, ec, potok::hpack::huffman_lookup::single_symbol);
+  auto const single_ec = ec;
+
+  auto const multi = decode(encoded, ec, potok::hpack::huffman_lookup::multi_symbol);
+
+  CHECK(single == multi);
+  CHECK(single_ec == ec);
+
+  return multi;
+}
+
+// feeds `encoded` to a `huffman_decoder` `chunk_size` octets at a time
+//
+auto decode_chunked(std::vector<u8> const&             encoded,       //
+                    usize const                        chunk_size,    //
+                    boost::system::error_code&         ec,            //
+                    potok::hpack::huffman_lookup const lookup) -> std::string
+{
+  auto out     = std::string(potok::hpack::huffman_max_decoded_size(encoded.size()), '\0');
+  auto out_buf = potok::span<u8>(reinterpret_cast<u8*>(out.data()), out.size());
+
+  auto d = potok::hpack::huffman_decoder(encoded.size(), lookup);
+
+  auto pos         = usize{0};
+  auto total       = usize{0};
+  auto num_written = usize{0};
+  do {
+    auto const n     = std::min(chunk_size, encoded.size() - pos);
+    auto const chunk = potok::span<u8 const>(encoded.data() + pos, n);
+
+    CHECK(d(chunk, out_buf.subspan(total), num_written, ec) == n);
+    pos += n;
+    total += num_written;
+    if (ec != potok::hpack::error::needs_more) { break; }
+  } while (true);
+
+  CHECK(pos == encoded.size());
+
+  out.resize(total);
+  return out;
+}
+
+// hands out exactly what's asked for from the general-purpose heap, keeping count
+//
+struct counting_resource : std::pmr::memory_resource {
+  usize num_allocations = 0;
+  usize num_bytes       = 0;
+
+ private:
+  auto do_allocate(std::size_t const bytes, std::size_t const alignment) -> void* override
+  {
+    ++num_allocations;
+    num_bytes += bytes;
+    return ::operator new(bytes, std::align_val_t{alignment});
+  }
+
+  auto do_deallocate(void* const p, std::size_t const bytes, std::size_t const alignment) -> void override
+  {
+    ::operator delete(p, bytes, std::align_val_t{alignment});
+  }
+
+  auto do_is_equal(std::pmr::memory_resource const& other) const noexcept -> bool override { return this == &other; }
+};
+
+}    // namespace
+
+TEST_CASE("The Huffman code should be a complete canonical prefix code")
+{
+  using potok::hpack::huffman_codes;
+
+  // spot checks against https://datatracker.ietf.org/doc/html/rfc7541#appendix-B
+  //
+  CHECK(huffman_codes[' '].code == 0x14);
+  CHECK(huffman_codes[' '].bit_len == 6);
+  CHECK(huffman_codes['a'].code == 0x3);
+  CHECK(huffman_codes['a'].bit_len == 5);
+  CHECK(huffman_codes[0xff].code == 0x3ffffee);
+  CHECK(huffman_codes[0xff].bit_len == 26);
+  CHECK(huffman_codes[potok::hpack::huffman_eos].code == 0x3fffffff);
+  CHECK(huffman_codes[potok::hpack::huffman_eos].bit_len == potok::hpack::huffman_max_bit_len);
+
+  // the Kraft sum of a complete code is exactly 1
+  //
+  auto kraft = u64{0};
+  for (auto const& c : huffman_codes) {
+    REQUIRE(c.bit_len >= 5);
+    REQUIRE(c.bit_len <= potok::hpack::huffman_max_bit_len);
+    REQUIRE(c.code < (u32{1} << c.bit_len));
+    kraft += u64{1} << (potok::hpack::huffman_max_bit_len - c.bit_len);
+  }
+  CHECK(kraft == (u64{1} << potok::hpack::huffman_max_bit_len));
+
+  // canonical: ordering the codes by (length, symbol) makes them consecutive once left-aligned
+  //
+  auto order = std::vector<u32>(257);
+  for (u32 sym = 0; sym < 257; ++sym) { order[sym] = sym; }
+  std::stable_sort(order.begin(), order.end(),
+                   [](u32 a, u32 b) { return huffman_codes[a].bit_len < huffman_codes[b].bit_len; });
+
+  for (usize i = 1; i < order.size(); ++i) {
+    auto const& prev = huffman_codes[order[i - 1]];
+    auto const& curr = huffman_codes[order[i]];
+
+    auto const prev_end = u64{prev.code + 1u} << (potok::hpack::huffman_max_bit_len - prev.bit_len);
+    auto const curr_beg = u64{curr.code} << (potok::hpack::huffman_max_bit_len - curr.bit_len);
+    REQUIRE(prev_end == curr_beg);
+  }
+}
+
+TEST_CASE("C.4. Request Examples with Huffman Coding")
+{
+  // https://datatracker.ietf.org/doc/html/rfc7541#appendix-C.4
+  //
+  auto ec = boost::system::error_code();
+
+  CHECK(decode({0xf1, 0xe3, 0xc2, 0xe5, 0xf2, 0x3a, 0x6b, 0xa0, 0xab, 0x90, 0xf4, 0xff}, ec) == "www.example.com");
+  CHECK(!ec);
+
+  CHECK(decode({0xa8, 0xeb, 0x10, 0x64, 0x9c, 0xbf}, ec) == "no-cache");
+  CHECK(!ec);
+
+  CHECK(decode({0x25, 0xa8, 0x49, 0xe9, 0x5b, 0xa9, 0x7d, 0x7f}, ec) == "custom-key");
+  CHECK(!ec);
+
+  CHECK(decode({0x25, 0xa8, 0x49, 0xe9, 0x5b, 0xb8, 0xe8, 0xb4, 0xbf}, ec) == "custom-value");
+  CHECK(!ec);
+}
+
+TEST_CASE("C.6. Response Examples with Huffman Coding")
+{
+  // https://datatracker.ietf.org/doc/html/rfc7541#appendix-C.6
+  //
+  auto ec = boost::system::error_code();
+
+  CHECK(decode({0x64, 0x02}, ec) == "302");
+  CHECK(!ec);
+
+  CHECK(decode({0xae, 0xc3, 0x77, 0x1a, 0x4b}, ec) == "private");
+  CHECK(!ec);
+
+  CHECK(decode({0xd0, 0x7a, 0xbe, 0x94, 0x10, 0x54, 0xd4, 0x44, 0xa8, 0x20, 0x05, 0x95, 0x04, 0x0b, 0x81, 0x66, 0xe0,
+                0x82, 0xa6, 0x2d, 0x1b, 0xff},
+               ec) == "Mon, 21 Oct 2013 20:13:21 GMT");
+  CHECK(!ec);
+
+  CHECK(decode({0x9d, 0x29, 0xad, 0x17, 0x18, 0x63, 0xc7, 0x8f, 0x0b, 0x97, 0xc8, 0xe9, 0xae, 0x82, 0xae, 0x43, 0xd3},
+               ec) == "https://www.example.com");
+  CHECK(!ec);
+
+  CHECK(decode({0x64, 0x0e, 0xff}, ec) == "307");
+  CHECK(!ec);
+
+  CHECK(decode({0x9b, 0xd9, 0xab}, ec) == "gzip");
+  CHECK(!ec);
+
+  CHECK(decode({0x94, 0xe7, 0x82, 0x1d, 0xd7, 0xf2, 0xe6, 0xc7, 0xb3, 0x35, 0xdf, 0xdf, 0xcd, 0x5b, 0x39,
+                0x60, 0xd5, 0xaf, 0x27, 0x08, 0x7f, 0x36, 0x72, 0xc1, 0xab, 0x27, 0x0f, 0xb5, 0x29, 0x1f,
+                0x95, 0x87, 0x31, 0x60, 0x65, 0xc0, 0x03, 0xed, 0x4e, 0xe5, 0xb1, 0x06, 0x3d, 0x50, 0x07},
+               ec) == "foo=ASDJKHQKBZXOQWEOPIUAXQWEOIU; max-age=3600; version=1");
+  CHECK(!ec);
+}
+
+TEST_CASE("Every symbol should decode, including the ones with codes longer than the primary table")
+{
+  auto syms     = std::vector<u32>();
+  auto expected = std::string();
+  for (u32 sym = 0; sym < 256; ++sym) {
+    syms.push_back(sym);
+    expected.push_back(static_cast<char>(sym));
+  }
+
+  for (usize i = 0; i < 8; ++i) {
+    // rotate the input so that every symbol gets decoded at different bit offsets
+    //
+    std::rotate(syms.begin(), syms.begin() + 37, syms.end());
+    std::rotate(expected.begin(), expected.begin() + 37, expected.end());
+
+    auto ec = boost::system::error_code();
+    REQUIRE(decode(reference_encode(syms), ec) == expected);
+    REQUIRE(!ec);
+  }
+
+  auto ec = boost::system::error_code();
+  CHECK(decode({}, ec).empty());
+  CHECK(!ec);
+}
+
+TEST_CASE("Malformed Huffman-coded strings should be rejected")
+{
+  auto ec = boost::system::error_code();
+
+  // an explicit EOS, wherever it is
+  //
+  decode(reference_encode({'a', 256}), ec);
+  CHECK(ec == potok::hpack::error::huffman_eos);
+
+  decode(reference_encode({256, 'a'}), ec);
+  CHECK(ec == potok::hpack::error::huffman_eos);
+
+  decode(reference_encode({'a', 'b', 'c', 'd', 'e', 'f', 'g', 256, 'h', 'i', 'j', 'k', 'l', 'm', 'n'}), ec);
+  CHECK(ec == potok::hpack::error::huffman_eos);
+
+  // 'a' is 00011 so a trailing 0xff makes for 11 bits of padding
+  //
+  decode({0b00011'111, 0xff}, ec);
+  CHECK(ec == potok::hpack::error::huffman_padding_too_long);
+
+  // a whole octet of padding on its own, and after a code ending on an octet boundary ("302" is 15 bits plus 1)
+  //
+  decode({0xff}, ec);
+  CHECK(ec == potok::hpack::error::huffman_padding_too_long);
+
+  decode({0x64, 0x02, 0xff}, ec);
+  CHECK(ec == potok::hpack::error::huffman_padding_too_long);
+
+  // padding that isn't all ones
+  //
+  decode({0b00011'101}, ec);
+  CHECK(ec == potok::hpack::error::huffman_invalid_padding);
+
+  decode({0b00011'011}, ec);
+  CHECK(ec == potok::hpack::error::huffman_invalid_padding);
+
+  // a short code, 3 bits of all-ones padding
+  //
+  CHECK(decode({0b00000'111}, ec) == "0");
+  CHECK(!ec);
+
+  // 7 bits of all-ones padding is the most there can be: "a//" is 5 + 6 + 6 = 17 bits, one past an octet boundary
+  //
+  CHECK(decode({0b00011'011, 0b000'01100, 0b0'1111111}, ec) == "a//");
+  CHECK(!ec);
+
+  // while another octet of it is too many, exactly 8 bits being covered by "302" above
+  //
+  decode({0b00011'011, 0b000'01100, 0b0'1111111, 0xff}, ec);
+  CHECK(ec == potok::hpack::error::huffman_padding_too_long);
+}
+
+TEST_CASE("Huffman-coded strings should decode the same regardless of how they're split up")
+{
+  auto const inputs = std::vector<std::vector<u8>>{
+      {0xf1, 0xe3, 0xc2, 0xe5, 0xf2, 0x3a, 0x6b, 0xa0, 0xab, 0x90, 0xf4, 0xff},
+      {0x9d, 0x29, 0xad, 0x17, 0x18, 0x63, 0xc7, 0x8f, 0x0b, 0x97, 0xc8, 0xe9, 0xae, 0x82, 0xae, 0x43, 0xd3},
+      {0x94, 0xe7, 0x82, 0x1d, 0xd7, 0xf2, 0xe6, 0xc7, 0xb3, 0x35, 0xdf, 0xdf, 0xcd, 0x5b, 0x39,
+       0x60, 0xd5, 0xaf, 0x27, 0x08, 0x7f, 0x36, 0x72, 0xc1, 0xab, 0x27, 0x0f, 0xb5, 0x29, 0x1f,
+       0x95, 0x87, 0x31, 0x60, 0x65, 0xc0, 0x03, 0xed, 0x4e, 0xe5, 0xb1, 0x06, 0x3d, 0x50, 0x07},
+      reference_encode({0, 10, 13, 22, 256 - 1, 'a', 'Z'}),
+  };
+
+  for (auto const lookup : {potok::hpack::huffman_lookup::single_symbol, potok::hpack::huffman_lookup::multi_symbol}) {
+    for (auto const& encoded : inputs) {
+      auto       ec       = boost::system::error_code();
+      auto const expected = decode(encoded, ec);
+      REQUIRE(!ec);
+
+      for (usize chunk_size = 1; chunk_size <= encoded.size(); ++chunk_size) {
+        CHECK(decode_chunked(encoded, chunk_size, ec, lookup) == expected);
+        CHECK(!ec);
+      }
+    }
+  }
+}
+
+TEST_CASE("The streaming Huffman decoder should accept buffer sequences and stop at the end of the literal")
+{
+  // "www.example.com" split over three segments, the last of which carries the start of the next field
+  //
+  auto const a = std::vector<u8>{0xf1, 0xe3, 0xc2};
+  auto const b = std::vector<u8>{};
+  auto const c = std::vector<u8>{0xe5, 0xf2, 0x3a, 0x6b, 0xa0, 0xab, 0x90, 0xf4, 0xff, 0x82, 0x86};
+
+  auto const bufs = std::vector<boost::asio::const_buffer>{
+      boost::asio::buffer(a), boost::asio::buffer(b), boost::asio::buffer(c)};
+
+  auto out     = std::string(potok::hpack::huffman_max_decoded_size(12), '\0');
+  auto out_buf = potok::span<u8>(reinterpret_cast<u8*>(out.data()), out.size());
+
+  auto ec          = boost::system::error_code();
+  auto num_written = usize{0};
+
+  auto d = potok::hpack::huffman_decoder(12);
+  CHECK(d(bufs, out_buf, num_written, ec) == 12);
+  CHECK(!ec);
+  out.resize(num_written);
+  CHECK(out == "www.example.com");
+
+  // partial input reports how much got decoded so far
+  //
+  auto partial = potok::hpack::huffman_decoder(12);
+  CHECK(partial(boost::asio::buffer(a), out_buf, num_written, ec) == 3);
+  CHECK(ec == potok::hpack::error::needs_more);
+  CHECK(num_written <= 4);
+
+  auto total = num_written;
+  CHECK(partial(boost::asio::buffer(b), out_buf.subspan(total), num_written, ec) == 0);
+  CHECK(ec == potok::hpack::error::needs_more);
+  CHECK(num_written == 0);
+
+  CHECK(partial(boost::asio::buffer(c), out_buf.subspan(total), num_written, ec) == 9);
+  CHECK(!ec);
+  total += num_written;
+  CHECK(std::string(out.data(), total) == "www.example.com");
+
+  // errors only show up once the padding is seen
+  //
+  auto const bad = std::vector<u8>{0b00011'111, 0xff};
+
+  auto invalid = potok::hpack::huffman_decoder(bad.size());
+  invalid(boost::asio::buffer(bad.data(), 1), out_buf, num_written, ec);
+  CHECK(ec == potok::hpack::error::needs_more);
+  invalid(boost::asio::buffer(bad.data() + 1, 1), out_buf, num_written, ec);
+  CHECK(ec == potok::hpack::error::huffman_padding_too_long);
+
+  // an empty literal finishes straight away
+  //
+  auto empty = potok::hpack::huffman_decoder(0);
+  CHECK(empty(boost::asio::buffer(c), out_buf, num_written, ec) == 0);
+  CHECK(!ec);
+  CHECK(num_written == 0);
+}
+
+TEST_CASE("Decoded field names and values should be validated in the same pass")
+{
+  using potok::hpack::huffman_validation;
+
+  auto const decode_as = [](std::vector<u8> const& encoded, huffman_validation const validation,
+                            boost::system::error_code& ec) {
+    auto out = std::string(potok::hpack::huffman_max_decoded_size(encoded.size()), '\0');
+    auto buf = potok::span<u8>(reinterpret_cast<u8*>(out.data()), out.size());
+
+    auto const single =
+        potok::hpack::decode_huffman(encoded, buf, ec, potok::hpack::huffman_lookup::single_symbol, validation);
+    auto const single_ec = ec;
+
+    auto const multi =
+        potok::hpack::decode_huffman(encoded, buf, ec, potok::hpack::huffman_lookup::multi_symbol, validation);
+
+    CHECK(single_ec == ec);
+    if (!ec) { CHECK(single == multi); }
+
+    out.resize(multi);
+    return out;
+  };
+
+  auto const syms = [](std::string const& str) {
+    auto v = std::vector<u32>();
+    for (auto const c : str) { v.push_back(static_cast<u8>(c)); }
+    return reference_encode(v);
+  };
+
+  auto ec = boost::system::error_code();
+
+  CHECK(decode_as(syms("custom-key"), huffman_validation::field_name, ec) == "custom-key");
+  CHECK(!ec);
+
+  CHECK(decode_as(syms(":authority"), huffman_validation::field_name, ec) == ":authority");
+  CHECK(!ec);
+
+  CHECK(decode_as(syms("Mon, 21 Oct 2013 20:13:21 GMT"), huffman_validation::field_value, ec) ==
+        "Mon, 21 Oct 2013 20:13:21 GMT");
+  CHECK(!ec);
+
+  // uppercase is fine in a value but not in a name, and the same goes for whitespace
+  //
+  decode_as(syms("Custom-Key"), huffman_validation::field_name, ec);
+  CHECK(ec == potok::hpack::error::invalid_field_name);
+
+  decode_as(syms("custom key"), huffman_validation::field_name, ec);
+  CHECK(ec == potok::hpack::error::invalid_field_name);
+
+  decode_as(syms("custom-\x7f"), huffman_validation::field_name, ec);
+  CHECK(ec == potok::hpack::error::invalid_field_name);
+
+  CHECK(decode_as(syms("Custom Key"), huffman_validation::field_value, ec) == "Custom Key");
+  CHECK(!ec);
+
+  for (auto const c : {'\0', '\r', '\n'}) {
+    auto value = std::string("a value");
+    value.insert(value.begin() + 3, c);
+
+    decode_as(syms(value), huffman_validation::field_value, ec);
+    CHECK(ec == potok::hpack::error::invalid_field_value);
+
+    decode_as(syms(value), huffman_validation::field_name, ec);
+    CHECK(ec == potok::hpack::error::invalid_field_name);
+
+    CHECK(decode_as(syms(value), huffman_validation::none, ec) == value);
+    CHECK(!ec);
+  }
+
+  // every symbol, including the ones only reachable through the canonical fallback
+  //
+  for (u32 sym = 0; sym < 256; ++sym) {
+    auto const invalid_name  = sym <= 0x20 || (sym >= 'A' && sym <= 'Z') || sym >= 0x7f;
+    auto const invalid_value = sym == 0 || sym == '\r' || sym == '\n';
+
+    decode_as(reference_encode({'a', sym, 'b'}), huffman_validation::field_name, ec);
+    CHECK((ec == potok::hpack::error::invalid_field_name) == invalid_name);
+
+    decode_as(reference_encode({'a', sym, 'b'}), huffman_validation::field_value, ec);
+    CHECK((ec == potok::hpack::error::invalid_field_value) == invalid_value);
+  }
+}
+
+TEST_CASE("Batch decoding should match decoding each string on its own")
+{
+  using potok::hpack::huffman_validation;
+
+  auto rng = std::mt19937(1337);
+
+  auto inputs      = std::vector<std::vector<u8>>();
+  auto validations = std::vector<huffman_validation>();
+
+  auto const lowercase = std::string("abcdefghijklmnopqrstuvwxyz-0123456789");
+  for (usize n = 0; n < 200; ++n) {
+    auto dist = std::uniform_int_distribution<u32>(0, 255);
+    auto len  = std::uniform_int_distribution<usize>(0, n % 7 == 0 ? 8 : 160)(rng);
+
+    auto syms = std::vector<u32>(len);
+    for (auto& sym : syms) {
+      sym = (n % 3 == 0) ? u32{static_cast<u8>(lowercase[dist(rng) % lowercase.size()])} : dist(rng);
+    }
+
+    // sprinkle in a few EOS symbols and bad padding
+    //
+    if (n % 11 == 0 && !syms.empty()) { syms[syms.size() / 2] = 256; }
+
+    auto encoded = reference_encode(syms);
+    if (n % 13 == 0 && !encoded.empty()) { encoded.back() &= 0xfe; }
+
+    inputs.push_back(std::move(encoded));
+    validations.push_back((n % 3 == 0)   ? huffman_validation::field_name
+                          : (n % 2 == 0) ? huffman_validation::field_value
+                                         : huffman_validation::none);
+  }
+
+  auto outputs = std::vector<std::string>(inputs.size());
+  auto items   = std::vector<potok::hpack::huffman_batch_item>(inputs.size());
+  for (usize i = 0; i < inputs.size(); ++i) {
+    outputs[i] = std::string(potok::hpack::huffman_max_decoded_size(inputs[i].size()), '\0');
+
+    items[i].encoded    = inputs[i];
+    items[i].out        = potok::span<u8>(reinterpret_cast<u8*>(outputs[i].data()), outputs[i].size());
+    items[i].validation = validations[i];
+  }
+
+  potok::hpack::decode_huffman_batch(items);
+
+  for (usize i = 0; i < inputs.size(); ++i) {
+    auto expected = std::string(potok::hpack::huffman_max_decoded_size(inputs[i].size()), '\0');
+    auto ec       = boost::system::error_code();
+
+    auto const n = potok::hpack::decode_huffman(
+        inputs[i], potok::span<u8>(reinterpret_cast<u8*>(expected.data()), expected.size()), ec,
+        potok::hpack::huffman_lookup::single_symbol, validations[i]);
+
+    REQUIRE(items[i].ec == ec);
+    if (!ec) {
+      REQUIRE(items[i].num_written == n);
+      REQUIRE(outputs[i].substr(0, n) == expected.substr(0, n));
+    }
+  }
+
+  // nothing to do is fine too
+  //
+  potok::hpack::decode_huffman_batch({});
+}
+
+TEST_CASE("Decoding into a memory_resource should allocate exactly once")
+{
+  using potok::hpack::huffman_lookup;
+
+  for (auto const lookup : {huffman_lookup::single_symbol, huffman_lookup::multi_symbol}) {
+    // '0' has a 5-bit code, so 40 of them are as dense as Huffman-coded data gets and fill the worst-case bound exactly
+    //
+    auto const dense = reference_encode(std::vector<u32>(40, '0'));
+    REQUIRE(dense.size() == 25);
+    REQUIRE(potok::hpack::huffman_max_decoded_size(dense.size()) == 40);
+
+    auto mr = counting_resource();
+    auto ec = boost::system::error_code();
+
+    auto const str = potok::hpack::decode_huffman(dense, &mr, ec, lookup);
+    CHECK(!ec);
+    CHECK(std::string_view(str) == std::string(40, '0'));
+    CHECK(mr.num_allocations == 1);
+
+    // long codes decode to fewer octets than the bound, which is shrunk to without going back to the resource
+    //
+    auto const sparse = reference_encode(std::vector<u32>(20, 0x00));
+
+    auto const str2 = potok::hpack::decode_huffman(sparse, &mr, ec, lookup);
+    CHECK(!ec);
+    CHECK(std::string_view(str2) == std::string(20, '\0'));
+    CHECK(mr.num_allocations == 2);
+
+    // errors leave the string with whatever was decoded up to that point
+    //
+    auto const eos = potok::hpack::decode_huffman(reference_encode({'a', 'b', 256, 'c', 'd', 'e', 'f', 'g', 'h', 'i'}),
+                                                  &mr, ec, lookup);
+    CHECK(ec == potok::hpack::error::huffman_eos);
+    CHECK(eos.size() <= 2);
+
+    // a fixed arena with no upstream fails loudly on anything but the single up-front allocation
+    //
+    u8   arena_buf[64] = {};
+    auto arena = std::pmr::monotonic_buffer_resource(arena_buf, sizeof(arena_buf), std::pmr::null_memory_resource());
+
+    auto const from_arena = potok::hpack::decode_huffman(dense, &arena, ec, lookup);
+    CHECK(!ec);
+    CHECK(std::string_view(from_arena) == std::string(40, '0'));
+  }
+}
@@ -0,0 +1,90 @@
+#define CATCH_CONFIG_MAIN
+#include "catch_amalgamated.hpp"
+
+#include <potok/hpack/huffman.hpp>
+
+#include <potok/span.hpp>
+#include <potok/stdint.hpp>
+
+#include <vector>
+
+using namespace potok::ints;
+
+// not part of the test suite, run with:
+//   ./huffman_decode_benchmark "[benchmark]"
+//
+
+namespace {
+
+// the Huffman-coded string literals from https://datatracker.ietf.org/doc/html/rfc7541#appendix-C.4 and C.6
+//
+auto const corpus = std::vector<std::vector<u8>>{
+    {0xf1, 0xe3, 0xc2, 0xe5, 0xf2, 0x3a, 0x6b, 0xa0, 0xab, 0x90, 0xf4, 0xff},
+    {0xa8, 0xeb, 0x10, 0x64, 0x9c, 0xbf},
+    {0x25, 0xa8, 0x49, 0xe9, 0x5b, 0xa9, 0x7d, 0x7f},
+    {0x25, 0xa8, 0x49, 0xe9, 0x5b, 0xb8, 0xe8, 0xb4, 0xbf},
+    {0x64, 0x02},
+    {0xae, 0xc3, 0x77, 0x1a, 0x4b},
+    {0xd0, 0x7a, 0xbe, 0x94, 0x10, 0x54, 0xd4, 0x44, 0xa8, 0x20, 0x05, 0x95, 0x04, 0x0b, 0x81, 0x66, 0xe0, 0x82, 0xa6,
+     0x2d, 0x1b, 0xff},
+    {0x9d, 0x29, 0xad, 0x17, 0x18, 0x63, 0xc7, 0x8f, 0x0b, 0x97, 0xc8, 0xe9, 0xae, 0x82, 0xae, 0x43, 0xd3},
+    {0x9b, 0xd9, 0xab},
+    {0x94, 0xe7, 0x82, 0x1d, 0xd7, 0xf2, 0xe6, 0xc7, 0xb3, 0x35, 0xdf, 0xdf, 0xcd, 0x5b, 0x39,
+     0x60, 0xd5, 0xaf, 0x27, 0x08, 0x7f, 0x36, 0x72, 0xc1, 0xab, 0x27, 0x0f, 0xb5, 0x29, 0x1f,
+     0x95, 0x87, 0x31, 0x60, 0x65, 0xc0, 0x03, 0xed, 0x4e, 0xe5, 0xb1, 0x06, 0x3d, 0x50, 0x07},
+};
+
+auto decode_corpus(potok::hpack::huffman_lookup const lookup) -> usize
+{
+  static auto out = std::vector<u8>(1024);
+
+  auto ec    = boost::system::error_code();
+  auto total = usize{0};
+  for (auto const& encoded : corpus) { total += potok::hpack::decode_huffman(encoded, out, ec, lookup); }
+  return total;
+}
+
+auto decode_corpus_batch() -> usize
+{
+  static auto out   = std::vector<std::vector<u8>>(corpus.size(), std::vector<u8>(1024));
+  static auto items = std::vector<potok::hpack::huffman_batch_item>(corpus.size());
+
+  for (usize i = 0; i < corpus.size(); ++i) {
+    items[i].encoded = corpus[i];
+    items[i].out     = out[i];
+  }
+
+  potok::hpack::decode_huffman_batch(items);
+
+  auto total = usize{0};
+  for (auto const& item : items) { total += item.num_written; }
+  return total;
+}
+
+}    // namespace
+
+TEST_CASE("Huffman decoding, single vs multi-symbol lookup", "[.][benchmark]")
+{
+  BENCHMARK("single_symbol")
+  {
+    return decode_corpus(potok::hpack::huffman_lookup::single_symbol);
+  };
+
+  BENCHMARK("multi_symbol")
+  {
+    return decode_corpus(potok::hpack::huffman_lookup::multi_symbol);
+  };
+}
+
+TEST_CASE("Huffman decoding, one string at a time vs interleaved", "[.][benchmark]")
+{
+  BENCHMARK("one at a time")
+  {
+    return decode_corpus(potok::hpack::huffman_lookup::single_symbol);
+  };
+
+  BENCHMARK("decode_huffman_batch")
+  {
+    return decode_corpus_batch();
+  };
+}
@@ -0,0 +1,150 @@
+#define CATCH_CONFIG_MAIN
+#include "catch_amalgamated.hpp"
+
+#include <potok/hpack/huffman.hpp>
+#include <potok/hpack/kernels.hpp>
+
+#include <potok/cpu.hpp>
+
+#include <potok/span.hpp>
+#include <potok/stdint.hpp>
+
+#include <boost/system/error_code.hpp>
+
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace potok::ints;
+
+namespace {
+
+auto as_octets(std::string const& str) -> potok::span<u8 const>
+{
+  return {reinterpret_cast<u8 const*>(str.data()), str.size()};
+}
+
+auto encode(std::string const& str) -> std::vector<u8>
+{
+  auto const size = potok::hpack::huffman_encoded_size(as_octets(str));
+
+  // one extra octet to catch writes past the precomputed size
+  //
+  auto out = std::vector<u8>(size + 1, 0xaa);
+
+  auto* end = potok::hpack::encode_huffman(as_octets(str), out);
+  CHECK(end == out.data() + size);
+  CHECK(out.back() == 0xaa);
+
+  out.pop_back();
+  return out;
+}
+
+auto decode(std::vector<u8> const& encoded) -> std::string
+{
+  auto out = std::string(potok::hpack::huffman_max_decoded_size(encoded.size()), '\0');
+  auto ec  = boost::system::error_code();
+
+  auto n = potok::hpack::decode_huffman(encoded, potok::span<u8>(reinterpret_cast<u8*>(out.data()), out.size()), ec);
+  CHECK(!ec);
+
+  out.resize(n);
+  return out;
+}
+
+}    // namespace
+
+TEST_CASE("C.4. Request Examples with Huffman Coding")
+{
+  // https://datatracker.ietf.org/doc/html/rfc7541#appendix-C.4
+  //
+  CHECK(encode("www.example.com") ==
+        std::vector<u8>{0xf1, 0xe3, 0xc2, 0xe5, 0xf2, 0x3a, 0x6b, 0xa0, 0xab, 0x90, 0xf4, 0xff});
+
+  CHECK(encode("no-cache") == std::vector<u8>{0xa8, 0xeb, 0x10, 0x64, 0x9c, 0xbf});
+  CHECK(encode("custom-key") == std::vector<u8>{0x25, 0xa8, 0x49, 0xe9, 0x5b, 0xa9, 0x7d, 0x7f});
+  CHECK(encode("custom-value") == std::vector<u8>{0x25, 0xa8, 0x49, 0xe9, 0x5b, 0xb8, 0xe8, 0xb4, 0xbf});
+}
+
+TEST_CASE("C.6. Response Examples with Huffman Coding")
+{
+  // https://datatracker.ietf.org/doc/html/rfc7541#appendix-C.6
+  //
+  CHECK(encode("302") == std::vector<u8>{0x64, 0x02});
+  CHECK(encode("private") == std::vector<u8>{0xae, 0xc3, 0x77, 0x1a, 0x4b});
+
+  CHECK(encode("Mon, 21 Oct 2013 20:13:21 GMT") ==
+        std::vector<u8>{0xd0, 0x7a, 0xbe, 0x94, 0x10, 0x54, 0xd4, 0x44, 0xa8, 0x20, 0x05,
+                        0x95, 0x04, 0x0b, 0x81, 0x66, 0xe0, 0x82, 0xa6, 0x2d, 0x1b, 0xff});
+
+  CHECK(encode("https://www.example.com") ==
+        std::vector<u8>{0x9d, 0x29, 0xad, 0x17, 0x18, 0x63, 0xc7, 0x8f, 0x0b,
+                        0x97, 0xc8, 0xe9, 0xae, 0x82, 0xae, 0x43, 0xd3});
+
+  CHECK(encode("307") == std::vector<u8>{0x64, 0x0e, 0xff});
+  CHECK(encode("gzip") == std::vector<u8>{0x9b, 0xd9, 0xab});
+
+  CHECK(encode("foo=ASDJKHQKBZXOQWEOPIUAXQWEOIU; max-age=3600; version=1") ==
+        std::vector<u8>{0x94, 0xe7, 0x82, 0x1d, 0xd7, 0xf2, 0xe6, 0xc7, 0xb3, 0x35, 0xdf, 0xdf, 0xcd, 0x5b, 0x39,
+                        0x60, 0xd5, 0xaf, 0x27, 0x08, 0x7f, 0x36, 0x72, 0xc1, 0xab, 0x27, 0x0f, 0xb5, 0x29, 0x1f,
+                        0x95, 0x87, 0x31, 0x60, 0x65, 0xc0, 0x03, 0xed, 0x4e, 0xe5, 0xb1, 0x06, 0x3d, 0x50, 0x07});
+}
+
+TEST_CASE("Encoding should round-trip through the decoder")
+{
+  CHECK(encode("").empty());
+
+  auto all = std::string();
+  for (u32 c = 0; c < 256; ++c) { all.push_back(static_cast<char>(c)); }
+  CHECK(decode(encode(all)) == all);
+
+  auto rng  = std::mt19937(1337);
+  auto dist = std::uniform_int_distribution<u32>(0, 255);
+  for (usize len = 0; len < 512; ++len) {
+    auto str = std::string(len, '\0');
+    for (auto& c : str) { c = static_cast<char>(dist(rng)); }
+
+    REQUIRE(decode(encode(str)) == str);
+  }
+}
+
+TEST_CASE("Every variant of the encoded size should match the scalar one")
+{
+  auto rng = std::mt19937(1337);
+
+  // all octets, and then just the printable ASCII ones that skip the upper half of the length table
+  //
+  for (auto const max_octet : {u32{255}, u32{126}}) {
+    auto dist = std::uniform_int_distribution<u32>(0, max_octet);
+    for (usize len = 0; len < 300; ++len) {
+      auto str = std::string(len, '\0');
+      for (auto& c : str) { c = static_cast<char>(dist(rng)); }
+
+      auto const expected = potok::hpack::detail::huffman_encoded_size_scalar(as_octets(str));
+      CHECK(potok::hpack::huffman_encoded_size(as_octets(str)) == expected);
+
+      for (auto level = potok::cpu_level::scalar; level <= potok::detect_cpu_level();
+           level      = static_cast<potok::cpu_level>(static_cast<u8>(level) + 1)) {
+        CHECK(potok::hpack::make_kernels(level).huffman_encoded_size(as_octets(str)) == expected);
+      }
+    }
+  }
+
+  // a long run of the longest codes, to catch any of the per-lane sums overflowing
+  //
+  auto const longest = std::string(4096, '\x16');
+  for (auto level = potok::cpu_level::scalar; level <= potok::detect_cpu_level();
+       level      = static_cast<potok::cpu_level>(static_cast<u8>(level) + 1)) {
+    CHECK(potok::hpack::make_kernels(level).huffman_encoded_size(as_octets(longest)) == 4096 * 30 / 8);
+  }
+}
+
+TEST_CASE("Huffman coding should only be chosen when it's shorter")
+{
+  CHECK(potok::hpack::huffman_is_shorter(as_octets("www.example.com")));
+  CHECK(potok::hpack::huffman_is_shorter(as_octets("no-cache")));
+
+  CHECK(!potok::hpack::huffman_is_shorter(as_octets("")));
+  CHECK(!potok::hpack::huffman_is_shorter(as_octets("\x80\x81\x82\x83")));
+  CHECK(!potok::hpack::huffman_is_shorter(as_octets("{}{}{}")));
+}
@@ -0,0 +1,65 @@
+#define CATCH_CONFIG_MAIN
+#include "catch_amalgamated.hpp"
+
+#include <potok/hpack/huffman.hpp>
+#include <potok/hpack/kernels.hpp>
+
+#include <potok/cpu.hpp>
+
+#include <potok/span.hpp>
+#include <potok/stdint.hpp>
+
+#include <random>
+#include <vector>
+
+using namespace potok::ints;
+
+// not part of the test suite, run with:
+//   ./huffman_encode_benchmark "[benchmark]"
+//
+// levels above what the CPU supports fall back to the best variant it does support
+//
+
+namespace {
+
+// something like a session token or a signed cookie: long, opaque and base64url-ish
+//
+auto make_token(usize const len) -> std::vector<u8>
+{
+  constexpr char const alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+  auto rng  = std::mt19937(1337);
+  auto dist = std::uniform_int_distribution<usize>(0, sizeof(alphabet) - 2);
+
+  auto token = std::vector<u8>(len);
+  for (auto& c : token) { c = static_cast<u8>(alphabet[dist(rng)]); }
+  return token;
+}
+
+}    // namespace
+
+TEST_CASE("Huffman encoded size vs encoding", "[.][benchmark]")
+{
+  auto const token = make_token(4096);
+  auto       out   = std::vector<u8>(potok::hpack::huffman_encoded_size(token));
+
+  BENCHMARK("huffman_encoded_size, scalar")
+  {
+    return potok::hpack::make_kernels(potok::cpu_level::scalar).huffman_encoded_size(token);
+  };
+
+  BENCHMARK("huffman_encoded_size, ssse3")
+  {
+    return potok::hpack::make_kernels(potok::cpu_level::ssse3).huffman_encoded_size(token);
+  };
+
+  BENCHMARK("huffman_encoded_size, avx2")
+  {
+    return potok::hpack::make_kernels(potok::cpu_level::avx2).huffman_encoded_size(token);
+  };
+
+  BENCHMARK("encode_huffman")
+  {
+    return potok::hpack::encode_huffman(token, out);
+  };
+}